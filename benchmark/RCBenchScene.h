@@ -0,0 +1,420 @@
+/*
+ * Copyright (c) 2023~Now Margoo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/**
+ * \file RCBenchScene.h
+ * \brief 性能测试与回归测试共用的场景：确定性生成的地图、纹理与相机路径
+ */
+
+#pragma once
+
+#include <include/RCRenderer.h>
+
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace RCBench {
+	inline RCTexture *CreateNoiseTexture(const int &Size, const unsigned &Seed) {
+		auto         context = new RCContext(Size, Size);
+		auto         buffer  = context->GetBuffer();
+		std::mt19937 random(Seed);
+		for (int position = 0; position < Size * Size; ++position) {
+			buffer[position] = 0xFF000000 | (random() & 0xFFFFFF);
+		}
+
+		return new RCTexture(context);
+	}
+	/**
+	 * 生成一张圆形的精灵纹理，圆外的像素完全透明
+	 */
+	inline RCTexture *CreateSpriteTexture(const int &Size, const unsigned &Seed) {
+		auto         context = new RCContext(Size, Size);
+		auto         buffer  = context->GetBuffer();
+		std::mt19937 random(Seed);
+		const float  radius = Size / 2.f;
+		for (int y = 0; y < Size; ++y) {
+			for (int x = 0; x < Size; ++x) {
+				const float offsetX = x + 0.5f - radius;
+				const float offsetY = y + 0.5f - radius;
+				const bool  inside  = offsetX * offsetX + offsetY * offsetY < radius * radius;
+				buffer[x + y * Size] = inside ? 0xFF000000 | (random() & 0xFFFFFF) : 0;
+			}
+		}
+
+		return new RCTexture(context);
+	}
+
+	struct Textures {
+		RCTexture *wall;
+		RCTexture *glass;
+		RCTexture *door;
+		RCTexture *floor;
+		RCTexture *ceiling;
+		RCTexture *skybox;
+		RCTexture *sprite;
+	};
+
+	/**
+	 * 一个基准测试场景：地图、精灵，以及相机沿途经过的格子（首尾相连的环路）
+	 */
+	struct BenchScene {
+		std::string                         name;
+		RCMap                              *map = nullptr;
+		std::vector<RCSprite>               sprites{};
+		std::vector<RCSprite *>             spritePointers{};
+		std::vector<RCMapDoor *>            doors{};
+		std::vector<vecmath::Vector<float>> path{};
+		// 相机左右摆动的幅度（弧度），用于让走廊两侧的门进入画面
+		float                               sway   = 0.f;
+		bool                                fog    = false;
+		bool                                skybox = false;
+	};
+
+	/**
+	 * 创建四周为墙、内部为空气的地图单位数组
+	 */
+	inline RCMapUnit *CreateUnits(const int &Size, RCTexture *WallTexture) {
+		auto units = new RCMapUnit[Size * Size];
+		for (int y = 0; y < Size; ++y) {
+			for (int x = 0; x < Size; ++x) {
+				auto &unit    = units[x + y * Size];
+				unit.Texture  = nullptr;
+				unit.Type     = RCMapUnitType::Air;
+				unit.Door     = nullptr;
+				unit.Passable = false;
+				if (x == 0 || y == 0 || x == Size - 1 || y == Size - 1) {
+					unit.Texture = WallTexture;
+					unit.Type    = RCMapUnitType::Wall;
+				}
+			}
+		}
+
+		return units;
+	}
+	inline void SetWall(RCMapUnit *Units, const int &Position, RCTexture *Texture, const RCMapUnitType &Type) {
+		Units[Position].Texture = Texture;
+		Units[Position].Type    = Type;
+	}
+	/**
+	 * 沿矩形的四条边生成首尾相连的路径，每格一个路径点
+	 */
+	inline std::vector<vecmath::Vector<float>> CreateLoopPath(const int &Left, const int &Top, const int &Right,
+	                                                          const int &Bottom) {
+		std::vector<vecmath::Vector<float>> path;
+		for (int x = Left; x < Right; ++x) {
+			path.emplace_back(x + 0.5f, Top + 0.5f, 0);
+		}
+		for (int y = Top; y < Bottom; ++y) {
+			path.emplace_back(Right + 0.5f, y + 0.5f, 0);
+		}
+		for (int x = Right; x > Left; --x) {
+			path.emplace_back(x + 0.5f, Bottom + 0.5f, 0);
+		}
+		for (int y = Bottom; y > Top; --y) {
+			path.emplace_back(Left + 0.5f, y + 0.5f, 0);
+		}
+
+		return path;
+	}
+
+	/**
+	 * 走廊迷宫：以深度优先搜索生成宽度为一格的迷宫，相机沿搜索的遍历顺序穿行于走廊中，画面几乎全部由近处的墙体组成
+	 */
+	inline BenchScene CreateCorridorMaze(const Textures &Textures) {
+		const int size  = 41;
+		auto      units = CreateUnits(size, Textures.wall);
+		for (int position = 0; position < size * size; ++position) {
+			SetWall(units, position, Textures.wall, RCMapUnitType::Wall);
+		}
+
+		std::mt19937                     random(1);
+		std::vector<bool>                visited(size * size, false);
+		std::vector<std::pair<int, int>> stack{ { 1, 1 } };
+		std::vector<std::pair<int, int>> tour{ { 1, 1 } };
+		visited[1 + size] = true;
+		SetWall(units, 1 + size, nullptr, RCMapUnitType::Air);
+		while (!stack.empty()) {
+			const auto [x, y] = stack.back();
+			std::vector<std::pair<int, int>> neighbors;
+			for (const auto &[offsetX, offsetY] : { std::pair{ 2, 0 }, std::pair{ -2, 0 }, std::pair{ 0, 2 }, std::pair{ 0, -2 } }) {
+				const int nextX = x + offsetX;
+				const int nextY = y + offsetY;
+				if (nextX > 0 && nextY > 0 && nextX < size - 1 && nextY < size - 1 && !visited[nextX + nextY * size]) {
+					neighbors.emplace_back(nextX, nextY);
+				}
+			}
+			if (neighbors.empty()) {
+				stack.pop_back();
+				if (!stack.empty()) {
+					// 回溯经过的格子同样计入遍历顺序，使相邻的路径点总是相邻的格子
+					tour.emplace_back((x + stack.back().first) / 2, (y + stack.back().second) / 2);
+					tour.push_back(stack.back());
+				}
+				continue;
+			}
+
+			const auto [nextX, nextY] = neighbors[random() % neighbors.size()];
+			visited[nextX + nextY * size] = true;
+			SetWall(units, (x + nextX) / 2 + (y + nextY) / 2 * size, nullptr, RCMapUnitType::Air);
+			SetWall(units, nextX + nextY * size, nullptr, RCMapUnitType::Air);
+			tour.emplace_back((x + nextX) / 2, (y + nextY) / 2);
+			tour.emplace_back(nextX, nextY);
+			stack.emplace_back(nextX, nextY);
+		}
+
+		// 只取遍历的前一段，并原路返回，使路径首尾相连
+		tour.resize(std::min<size_t>(tour.size(), 160));
+		BenchScene scene{ .name = "corridor_maze", .map = new RCMap(size, size, units) };
+		for (const auto &[x, y] : tour) {
+			scene.path.emplace_back(x + 0.5f, y + 0.5f, 0);
+		}
+		for (int index = static_cast<int>(tour.size()) - 2; index > 0; --index) {
+			scene.path.emplace_back(tour[index].first + 0.5f, tour[index].second + 0.5f, 0);
+		}
+		scene.sway   = 0.f;
+		scene.fog    = false;
+		scene.skybox = false;
+
+		return scene;
+	}
+	/**
+	 * 开阔场地：稀疏的柱子，启用天空盒与烟雾，画面主要由地板、天空盒与远处的墙体组成，光线的步数最多
+	 */
+	inline BenchScene CreateOpenField(const Textures &Textures) {
+		const int    size  = 96;
+		auto         units = CreateUnits(size, Textures.wall);
+		std::mt19937 random(2);
+		for (int y = 2; y < size - 2; ++y) {
+			for (int x = 2; x < size - 2; ++x) {
+				// 相机行走的环路两侧不放置柱子
+				const bool lane = (std::abs(x - 12) <= 1 || std::abs(x - 83) <= 1 || std::abs(y - 12) <= 1 ||
+				                   std::abs(y - 83) <= 1);
+				if (!lane && random() % 48 == 0) {
+					SetWall(units, x + y * size, Textures.wall, RCMapUnitType::Wall);
+				}
+			}
+		}
+
+		BenchScene scene{ .name = "open_field", .map = new RCMap(size, size, units) };
+		scene.path   = CreateLoopPath(12, 12, 83, 83);
+		scene.sway   = 0.6f;
+		scene.fog    = true;
+		scene.skybox = true;
+
+		return scene;
+	}
+	/**
+	 * 大量玻璃：一排排留有缺口的玻璃墙，相机在缺口所在的行中穿行，每条光线都会穿过多层玻璃
+	 */
+	inline BenchScene CreateGlassHeavy(const Textures &Textures) {
+		const int size  = 48;
+		auto      units = CreateUnits(size, Textures.wall);
+		for (int y = 1; y < size - 1; ++y) {
+			for (int x = 3; x < size - 3; x += 3) {
+				if (y % 6 != 3) {
+					SetWall(units, x + y * size, Textures.glass, RCMapUnitType::Glass);
+				}
+			}
+		}
+
+		BenchScene scene{ .name = "glass_heavy", .map = new RCMap(size, size, units) };
+		// 在缺口所在的行之间往返
+		for (int row = 3; row < size - 3; row += 6) {
+			const bool forward = row / 6 % 2 == 0;
+			for (int step = 1; step < size - 1; ++step) {
+				const int x = forward ? step : size - 1 - step;
+				scene.path.emplace_back(x + 0.5f, row + 0.5f, 0);
+			}
+			const int x = forward ? size - 2 : 1;
+			for (int y = row + 1; y < row + 6 && y < size - 3; ++y) {
+				scene.path.emplace_back(x + 0.5f, y + 0.5f, 0);
+			}
+		}
+		// 原路返回，使路径首尾相连
+		for (int index = static_cast<int>(scene.path.size()) - 2; index > 0; --index) {
+			scene.path.push_back(scene.path[index]);
+		}
+		scene.sway   = 0.3f;
+		scene.fog    = false;
+		scene.skybox = false;
+
+		return scene;
+	}
+	/**
+	 * 大量门：走廊两侧是一排房间，每个房间都有一扇开合程度不同的门，门在测试中持续开合
+	 */
+	inline BenchScene CreateDoorHeavy(const Textures &Textures) {
+		const int                size  = 48;
+		auto                     units = CreateUnits(size, Textures.wall);
+		std::vector<RCMapDoor *> doors;
+		for (int x = 1; x < size - 1; ++x) {
+			for (const int wallY : { 22, 25 }) {
+				const int position = x + wallY * size;
+				if (x % 4 == 2) {
+					auto door = new RCMapDoor(Textures.door);
+					SetWall(units, position, Textures.door, RCMapUnitType::Door);
+					units[position].Door = door;
+					doors.push_back(door);
+				} else {
+					SetWall(units, position, Textures.wall, RCMapUnitType::Wall);
+				}
+			}
+			// 房间之间的隔墙
+			if (x % 4 == 0) {
+				for (int y = 1; y < size - 1; ++y) {
+					if (y < 22 || y > 25) {
+						SetWall(units, x + y * size, Textures.wall, RCMapUnitType::Wall);
+					}
+				}
+			}
+		}
+
+		BenchScene scene{ .name = "door_heavy", .map = new RCMap(size, size, units) };
+		scene.doors = doors;
+		for (int x = 1; x < size - 1; ++x) {
+			scene.path.emplace_back(x + 0.5f, 23.5f, 0);
+		}
+		for (int x = size - 2; x > 0; --x) {
+			scene.path.emplace_back(x + 0.5f, 24.5f, 0);
+		}
+		scene.sway   = 1.1f;
+		scene.fog    = true;
+		scene.skybox = false;
+
+		return scene;
+	}
+	/**
+	 * 大量精灵：开阔的房间中随机分布着大量精灵，许多列需要绘制多个相互遮挡的精灵，房间中的柱子有一部分是斜墙
+	 */
+	inline BenchScene CreateSpriteDense(const Textures &Textures) {
+		const int    size  = 48;
+		auto         units = CreateUnits(size, Textures.wall);
+		std::mt19937 random(5);
+		const RCMapUnitType pillars[] = { RCMapUnitType::Wall, RCMapUnitType::DiagWallLeftRight,
+		                                  RCMapUnitType::DiagWallRightLeft };
+		for (int y = 4; y < size - 4; y += 8) {
+			for (int x = 4; x < size - 4; x += 8) {
+				SetWall(units, x + y * size, Textures.wall, pillars[(x / 8 + y / 8) % 3]);
+			}
+		}
+
+		BenchScene scene{ .name = "sprite_dense", .map = new RCMap(size, size, units) };
+		std::uniform_real_distribution<float> position(1.5f, size - 1.5f);
+		scene.sprites.resize(512);
+		for (auto &sprite : scene.sprites) {
+			sprite.texture = Textures.sprite;
+			sprite.x       = position(random);
+			sprite.y       = position(random);
+			sprite.z       = 0;
+		}
+		for (auto &sprite : scene.sprites) {
+			scene.spritePointers.push_back(&sprite);
+		}
+		scene.path   = CreateLoopPath(6, 6, 41, 41);
+		scene.sway   = 0.4f;
+		scene.fog    = false;
+		scene.skybox = false;
+
+		return scene;
+	}
+
+	/**
+	 * 依据帧序号计算相机的位姿：沿路径匀速前进，朝向路径前方并左右摆动，同时轻微地上下俯仰
+	 */
+	inline void SetCameraPose(RCCamera &Camera, const BenchScene &Scene, const int &Frame, const int &FrameCount) {
+		const auto pointAt = [&](const float &Progress) {
+			const float size     = static_cast<float>(Scene.path.size());
+			const float position = std::fmod(Progress * size, size);
+			const int   index    = static_cast<int>(position);
+			const auto &from     = Scene.path[index];
+			const auto &to       = Scene.path[(index + 1) % Scene.path.size()];
+			const float fraction = position - static_cast<float>(index);
+
+			return vecmath::Vector<float>(from.x + (to.x - from.x) * fraction, from.y + (to.y - from.y) * fraction, 0);
+		};
+		const float progress = static_cast<float>(Frame) / static_cast<float>(FrameCount);
+		const auto  position = pointAt(progress);
+		const auto  ahead    = pointAt(progress + 1.5f / static_cast<float>(Scene.path.size()));
+		const float phase    = 6.2831853f * progress;
+		float       angle    = std::atan2(ahead.y - position.y, ahead.x - position.x);
+		angle += Scene.sway * std::sin(phase * 7.f);
+
+		Camera.Position  = position;
+		Camera.Direction = vecmath::Vector<float>(std::cos(angle), std::sin(angle), 0);
+		Camera.Plane     = vecmath::Vector<float>(-std::sin(angle) * 0.66f, std::cos(angle) * 0.66f, 0);
+		Camera.SetPitch(0.2f * std::sin(phase * 3.f));
+	}
+	/**
+	 * 让门以各自的相位持续开合
+	 */
+	inline void AnimateDoors(const BenchScene &Scene, const int &Frame) {
+		for (size_t index = 0; index < Scene.doors.size(); ++index) {
+			auto        door  = Scene.doors[index];
+			const float phase = 0.5f + 0.5f * std::sin(static_cast<float>(Frame) * 0.05f + static_cast<float>(index));
+			door->Offset      = door->Min + static_cast<float>(door->Max - door->Min) * phase;
+		}
+	}
+	/**
+	 * 创建测试场景使用的纹理
+	 */
+	inline Textures CreateTextures() {
+		Textures textures{};
+		textures.wall    = CreateNoiseTexture(256, 1);
+		textures.glass   = CreateNoiseTexture(64, 2);
+		textures.door    = CreateNoiseTexture(64, 3);
+		textures.floor   = CreateNoiseTexture(256, 4);
+		textures.ceiling = CreateNoiseTexture(256, 5);
+		textures.skybox  = CreateNoiseTexture(512, 6);
+		textures.sprite  = CreateSpriteTexture(64, 7);
+
+		return textures;
+	}
+	/**
+	 * 依次创建走廊迷宫、开阔场地、大量玻璃、大量门与大量精灵五个场景
+	 */
+	inline std::vector<BenchScene> CreateScenes(const Textures &Textures) {
+		std::vector<BenchScene> scenes;
+		scenes.push_back(CreateCorridorMaze(Textures));
+		scenes.push_back(CreateOpenField(Textures));
+		scenes.push_back(CreateGlassHeavy(Textures));
+		scenes.push_back(CreateDoorHeavy(Textures));
+		scenes.push_back(CreateSpriteDense(Textures));
+
+		return scenes;
+	}
+	/**
+	 * 依据测试场景设置渲染场景的精灵、纹理、天空盒与烟雾
+	 */
+	inline void SetupScene(RCScene &Scene, BenchScene &Source, const Textures &Textures) {
+		Scene.SpriteList  = Source.spritePointers.empty() ? nullptr : Source.spritePointers.data();
+		Scene.SpriteCount = static_cast<int>(Source.spritePointers.size());
+		Scene.SetFloorTexture(Textures.floor);
+		Scene.SetCeilingTexture(Textures.ceiling);
+		Scene.SetSkyBoxTexture(Textures.skybox);
+		Scene.EnableSkyBox(Source.skybox);
+		Scene.SetFogLevel(3.f);
+		Scene.EnableFog(Source.fog);
+	}
+}
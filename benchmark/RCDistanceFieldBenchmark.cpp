@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2023~Now Margoo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/**
+ * \file RCDistanceFieldBenchmark.cpp
+ * \brief 比较逐格步进与借助距离场跳过空旷区域时，每条光线的平均步数与耗时
+ */
+
+#include <include/RCMap.h>
+
+#include <chrono>
+#include <format>
+#include <iostream>
+#include <random>
+
+namespace {
+	/**
+	 * 生成一张开阔的地图：四周为墙，内部零散分布着柱子与几个房间
+	 */
+	RCMap *CreateOpenPlanMap(const int &Width, const int &Height) {
+		auto units = new RCMapUnit[Width * Height];
+		std::mt19937 random(2023);
+		for (int y = 0; y < Height; ++y) {
+			for (int x = 0; x < Width; ++x) {
+				auto &unit   = units[x + y * Width];
+				unit.Texture = nullptr;
+				unit.Type    = RCMapUnitType::Air;
+
+				const bool border = x == 0 || y == 0 || x == Width - 1 || y == Height - 1;
+				const bool pillar = random() % 4096 == 0;
+				// 每 256 格一个 32 x 32 的房间，房间的墙上留有门洞
+				const int  roomX  = x % 256;
+				const int  roomY  = y % 256;
+				const bool room   = ((roomX == 96 || roomX == 128) && roomY >= 96 && roomY <= 128 && roomY != 112) ||
+				                    ((roomY == 96 || roomY == 128) && roomX >= 96 && roomX <= 128 && roomX != 112);
+				if (border || pillar || room) {
+					unit.Type = RCMapUnitType::Wall;
+				}
+			}
+		}
+
+		return new RCMap(Width, Height, units);
+	}
+
+	struct Result {
+		double stepsPerRay;
+		double nanosecondsPerRay;
+	};
+
+	/**
+	 * 从随机的位置向随机的方向投射光线，直到击中非空气的格子
+	 */
+	Result CastRays(RCMap *Map, const int &RayCount, const bool &SkipEmptySpace) {
+		std::mt19937                          random(1);
+		std::uniform_real_distribution<float> positionX(1.f, static_cast<float>(Map->GetWidth() - 1));
+		std::uniform_real_distribution<float> positionY(1.f, static_cast<float>(Map->GetHeight() - 1));
+		std::uniform_real_distribution<float> angle(0.f, 6.2831853f);
+
+		long long steps    = 0;
+		int       checksum = 0;
+		auto      start    = std::chrono::steady_clock::now();
+		for (int count = 0; count < RayCount; ++count) {
+			vecmath::Vector<float> position(positionX(random), positionY(random), 0);
+			const float            rayAngle = angle(random);
+			vecmath::Vector<float> direction(std::cos(rayAngle), std::sin(rayAngle), 0);
+
+			RCMapRay ray(position, direction);
+			while (true) {
+				if (SkipEmptySpace) {
+					Map->SkipEmptySpace(ray);
+				}
+				ray.Step();
+				++steps;
+				if (!Map->IsEmpty(ray.mapX + ray.mapY * Map->GetWidth())) {
+					break;
+				}
+			}
+			checksum += ray.mapX ^ ray.mapY;
+		}
+		auto end = std::chrono::steady_clock::now();
+
+		// 避免编译器优化掉光线投射
+		if (checksum == 42) {
+			std::cout << "";
+		}
+
+		return {static_cast<double>(steps) / RayCount,
+		        std::chrono::duration<double, std::nano>(end - start).count() / RayCount};
+	}
+}
+
+int main(int argc, char **argv) {
+	const int size     = argc > 1 ? std::atoi(argv[1]) : 2048;
+	const int rayCount = argc > 2 ? std::atoi(argv[2]) : 1000000;
+
+	auto buildStart = std::chrono::steady_clock::now();
+	auto map        = CreateOpenPlanMap(size, size);
+	auto buildEnd   = std::chrono::steady_clock::now();
+
+	std::cout << std::format("map {}x{}, distance field built in {:.1f} ms, {} rays\n", size, size,
+	                         std::chrono::duration<double, std::milli>(buildEnd - buildStart).count(), rayCount);
+
+	auto stepped = CastRays(map, rayCount, false);
+	auto skipped = CastRays(map, rayCount, true);
+	std::cout << std::format("{:<16}{:>16}{:>16}\n", "mode", "steps/ray", "ns/ray");
+	std::cout << std::format("{:<16}{:>16.2f}{:>16.1f}\n", "cell-by-cell", stepped.stepsPerRay, stepped.nanosecondsPerRay);
+	std::cout << std::format("{:<16}{:>16.2f}{:>16.1f}\n", "distance field", skipped.stepsPerRay, skipped.nanosecondsPerRay);
+
+	// 随机修改地图的单位，测量距离场增量更新的耗时
+	std::mt19937 random(3);
+	const int    updateCount = 1000;
+	auto         updateStart = std::chrono::steady_clock::now();
+	for (int count = 0; count < updateCount; ++count) {
+		const int position = static_cast<int>(random() % static_cast<unsigned>(size * size));
+		RCMapUnit unit     = map->GetMapUnit(position);
+		unit.Type          = unit.Type == RCMapUnitType::Air ? RCMapUnitType::Wall : RCMapUnitType::Air;
+		map->SetMapUnit(position, unit);
+	}
+	auto updateEnd = std::chrono::steady_clock::now();
+	std::cout << std::format("incremental update: {:.1f} us per changed cell\n",
+	                         std::chrono::duration<double, std::micro>(updateEnd - updateStart).count() / updateCount);
+
+	delete map;
+
+	return 0;
+}
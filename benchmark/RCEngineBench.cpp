@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2023~Now Margoo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/**
+ * \file RCEngineBench.cpp
+ * \brief 在确定性生成的地图中按预定的路径移动相机，以多种分辨率测量渲染器的性能，并以 JSON 格式输出结果
+ */
+
+#include <benchmark/RCBenchScene.h>
+#include <benchmark/RCPerfCounters.h>
+
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string_view>
+
+namespace {
+	struct Result {
+		std::string scene;
+		int         width;
+		int         height;
+		int         frames;
+		double      framesPerSecond;
+		double      nanosecondsPerPixel;
+		double      stepsPerRay;
+		// 各阶段的耗时统计，下标为 RCProfileStage
+		RCProfileSummary stages[RCProfileStageCount]{};
+		// 各阶段每帧的硬件计数器的平均值，仅在启用计数器时统计
+		double counters[RCProfileStageCount][RCBench::PerfCounterCount]{};
+	};
+
+	Result RunScene(RCBench::BenchScene &Scene, const RCBench::Textures &Textures, const int &Width, const int &Height,
+	                const int &FrameCount, const int &ThreadCount, RCBench::PerfCounters *Counters) {
+		RCScene scene(Scene.map);
+		RCBench::SetupScene(scene, Scene, Textures);
+
+		RCContext      context(Width, Height);
+		RCRenderTarget renderTarget(&context);
+		RCCamera       camera(Scene.path.front(), vecmath::Vector<float>(1, 0, 0), 1.15f);
+		RCRenderer     renderer(&renderTarget, &camera, &scene);
+		renderer.EnableSuperResolution(false);
+		renderer.SetThreadCount(ThreadCount);
+		renderer.SetProfileCounters(Counters);
+
+		// 先渲染几帧预热缓存与线程池
+		for (int frame = 0; frame < 4; ++frame) {
+			RCBench::SetCameraPose(camera, Scene, frame, FrameCount);
+			renderer.Render();
+		}
+		renderer.GetProfiler().SetCapacity(FrameCount);
+
+		long long steps = 0;
+		long long rays  = 0;
+		long long counters[RCProfileStageCount][RCBench::PerfCounterCount]{};
+		auto      start = std::chrono::steady_clock::now();
+		for (int frame = 0; frame < FrameCount; ++frame) {
+			RCBench::SetCameraPose(camera, Scene, frame, FrameCount);
+			RCBench::AnimateDoors(Scene, frame);
+			renderer.Render();
+
+			const auto statistics = renderer.GetStatistics();
+			steps += statistics.traceSteps;
+			rays  += statistics.tracedRays;
+			if (Counters != nullptr) {
+				const auto &stageCounters = renderer.GetStageCounters();
+				for (int stage = 0; stage < RCProfileStageCount; ++stage) {
+					for (int counter = 0; counter < RCBench::PerfCounterCount; ++counter) {
+						counters[stage][counter] += stageCounters[stage][counter];
+					}
+				}
+			}
+		}
+		auto end = std::chrono::steady_clock::now();
+		renderer.GetProfiler().CommitFrame();
+
+		const double elapsed = std::chrono::duration<double, std::nano>(end - start).count();
+		Result       result{ .scene               = Scene.name,
+		                     .width               = Width,
+		                     .height              = Height,
+		                     .frames              = FrameCount,
+		                     .framesPerSecond     = FrameCount / (elapsed / 1e9),
+		                     .nanosecondsPerPixel = elapsed / (static_cast<double>(FrameCount) * Width * Height),
+		                     .stepsPerRay = rays == 0 ? 0 : static_cast<double>(steps) / static_cast<double>(rays) };
+		for (int stage = 0; stage < RCProfileStageCount; ++stage) {
+			result.stages[stage] = renderer.GetProfiler().GetSummary(static_cast<RCProfileStage>(stage));
+			for (int counter = 0; counter < RCBench::PerfCounterCount; ++counter) {
+				result.counters[stage][counter] = static_cast<double>(counters[stage][counter]) / FrameCount;
+			}
+		}
+
+		return result;
+	}
+
+	void WriteJSON(std::ostream &Stream, const std::vector<Result> &Results, const int &FrameCount,
+	               const int &ThreadCount, const RCBench::PerfCounters *Counters) {
+		Stream << std::format("{{\n  \"benchmark\": \"RCEngineBench\",\n  \"frames\": {},\n  \"threads\": {},\n",
+		                      FrameCount, ThreadCount);
+		// 只列出可用的计数器，请求了计数器却无法打开时记为不可用
+		if (Counters != nullptr) {
+			Stream << "  \"counters\": [";
+			bool first = true;
+			for (int counter = 0; counter < RCBench::PerfCounterCount; ++counter) {
+				if (Counters->IsAvailable(static_cast<RCBench::PerfCounter>(counter))) {
+					Stream << std::format("{}\"{}\"", first ? "" : ", ",
+					                      RCBench::GetPerfCounterName(static_cast<RCBench::PerfCounter>(counter)));
+					first = false;
+				}
+			}
+			Stream << "],\n";
+		}
+		Stream << "  \"results\": [";
+		for (size_t index = 0; index < Results.size(); ++index) {
+			const auto &result = Results[index];
+			Stream << std::format("{}\n    {{\"scene\": \"{}\", \"width\": {}, \"height\": {}, \"frames\": {}, "
+			                      "\"fps\": {:.3f}, \"nsPerPixel\": {:.4f}, \"stepsPerRay\": {:.3f}, \"passes\": {{",
+			                      index == 0 ? "" : ",", result.scene, result.width, result.height, result.frames,
+			                      result.framesPerSecond, result.nanosecondsPerPixel, result.stepsPerRay);
+			for (int stage = 0; stage < RCProfileStageCount; ++stage) {
+				// 提交画布不在渲染器内，基准测试中没有这一阶段
+				if (static_cast<RCProfileStage>(stage) == RCProfileStage::Flush) {
+					continue;
+				}
+				const auto &summary = result.stages[stage];
+				Stream << std::format("{}\n      \"{}\": {{\"average\": {:.4f}, \"p50\": {:.4f}, \"p95\": {:.4f}, "
+				                      "\"p99\": {:.4f}, \"max\": {:.4f}",
+				                      stage == 0 ? "" : ",", RCProfiler::GetStageName(static_cast<RCProfileStage>(stage)),
+				                      summary.average, summary.p50, summary.p95, summary.p99, summary.max);
+				if (Counters != nullptr && Counters->IsAvailable()) {
+					Stream << ", \"counters\": {";
+					bool first = true;
+					for (int counter = 0; counter < RCBench::PerfCounterCount; ++counter) {
+						const auto perfCounter = static_cast<RCBench::PerfCounter>(counter);
+						if (Counters->IsAvailable(perfCounter)) {
+							Stream << std::format("{}\"{}\": {:.1f}", first ? "" : ", ",
+							                      RCBench::GetPerfCounterName(perfCounter), result.counters[stage][counter]);
+							first = false;
+						}
+					}
+					Stream << "}";
+				}
+				Stream << "}";
+			}
+			Stream << "}}";
+		}
+		Stream << "\n  ]\n}\n";
+	}
+}
+
+int main(int argc, char **argv) {
+	// --counters 可以出现在任意位置，其余参数依次为帧数、线程数与 JSON 输出路径
+	bool                      enableCounters = false;
+	std::vector<const char *> arguments;
+	for (int index = 1; index < argc; ++index) {
+		if (std::string_view(argv[index]) == "--counters") {
+			enableCounters = true;
+		} else {
+			arguments.push_back(argv[index]);
+		}
+	}
+	const int   frameCount  = arguments.size() > 0 ? std::atoi(arguments[0]) : 120;
+	const int   threadCount = arguments.size() > 1 ? std::atoi(arguments[1]) : 1;
+	const char *outputPath  = arguments.size() > 2 ? arguments[2] : nullptr;
+
+	std::unique_ptr<RCBench::PerfCounters> counters;
+	if (enableCounters) {
+		counters = std::make_unique<RCBench::PerfCounters>();
+		if (!counters->IsAvailable()) {
+			std::cerr << "Hardware performance counters are unavailable, only timings will be reported\n";
+		}
+	}
+
+	const auto textures = RCBench::CreateTextures();
+	auto       scenes   = RCBench::CreateScenes(textures);
+
+	const int           resolutions[][2] = { { 320, 240 }, { 640, 480 }, { 1920, 1080 } };
+	std::vector<Result> results;
+	for (auto &scene : scenes) {
+		for (const auto &resolution : resolutions) {
+			results.push_back(RunScene(scene, textures, resolution[0], resolution[1], frameCount, threadCount,
+			                           counters != nullptr && counters->IsAvailable() ? counters.get() : nullptr));
+
+			const auto &result = results.back();
+			std::cerr << std::format("{:<16}{:>12}{:>12.1f} fps{:>10.3f} ns/pixel{:>8.2f} steps/ray\n", result.scene,
+			                         std::format("{}x{}", result.width, result.height), result.framesPerSecond,
+			                         result.nanosecondsPerPixel, result.stepsPerRay);
+		}
+	}
+
+	if (outputPath != nullptr) {
+		std::ofstream stream(outputPath);
+		WriteJSON(stream, results, frameCount, threadCount, counters.get());
+	} else {
+		WriteJSON(std::cout, results, frameCount, threadCount, counters.get());
+	}
+
+	for (auto &scene : scenes) {
+		delete scene.map;
+	}
+
+	return 0;
+}
@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2023~Now Margoo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * \file RCKernelBenchmark.cpp
+ * \brief 比较按特性特化的列内核与行扫描内核，与逐像素判断特性的通用实现之间的耗时，并检查两者的结果是否一致
+ */
+
+#include <include/RCColumnKernel.h>
+
+#include <chrono>
+#include <format>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+	/**
+	 * 特化之前的列内核，逐像素判断烟雾、明暗面与混合，作为比较的基准
+	 */
+	void RenderColumnGeneric(const RCRender::ColumnSpan &Span, const unsigned &Features) {
+		const int   shade    = static_cast<int>(Features >> 2);
+		const BYTE *colormap = (Features & RCRender::ColumnFeature::Fog) != 0 ? Span.colormap : nullptr;
+		const int   stride   = Span.outputStride;
+		int         textureY = Span.textureY;
+		auto        stepper  = Span.stepper;
+		for (int y = Span.begin; y < Span.end; ++y) {
+			COLORREF color = Span.texels[textureY * Span.texelStride];
+			if (((color & 0xFF000000)) != 0) {
+				if (colormap != nullptr) {
+					color = RGB(colormap[GetRValue(color) >> shade], colormap[256 + (GetGValue(color) >> shade)],
+					            colormap[512 + (GetBValue(color) >> shade)]);
+				} else if (shade == 1) {
+					color = (color >> 1) & 8355711;
+				} else if (shade == 2) {
+					color = (color >> 2) & 0x3F3F3F;
+				}
+
+				if ((Features & RCRender::ColumnFeature::Blend) != 0) {
+					color = ((color & 0xFEFEFE) >> 1) + ((Span.output[y * stride] & 0xFEFEFE) >> 1);
+				}
+				Span.output[y * stride] = color;
+			}
+
+			textureY = RCRender::GetStepperTexel(stepper.position);
+			stepper.position += stepper.step;
+		}
+	}
+	/**
+	 * 特化之前的标量行扫描内核，逐像素判断天花板与烟雾，作为比较的基准
+	 */
+	void RenderFloorSpanGeneric(const RCRender::FloorSpan &Span, const unsigned &Features) {
+		const bool  ceiling  = (Features & RCRender::FloorFeature::Ceiling) != 0;
+		const BYTE *colormap = (Features & RCRender::FloorFeature::Fog) != 0 ? Span.colormap : nullptr;
+		const auto  width    = static_cast<float>(Span.textureWidth);
+		const auto  height   = static_cast<float>(Span.textureHeight);
+		for (int x = Span.begin; x < Span.end; ++x) {
+			float positionX = Span.positionX + static_cast<float>(x) * Span.stepX;
+			float positionY = Span.positionY + static_cast<float>(x) * Span.stepY;
+			float cellX     = static_cast<float>(static_cast<int>(positionX));
+			float cellY     = static_cast<float>(static_cast<int>(positionY));
+			float fractionX = ceiling ? cellX - positionX : positionX - cellX;
+			float fractionY = ceiling ? cellY - positionY : positionY - cellY;
+			int   textureX  = static_cast<int>(width * fractionX) & (Span.textureWidth - 1);
+			int   textureY  = static_cast<int>(height * fractionY) & (Span.textureHeight - 1);
+
+			auto textureColor = Span.texture[Span.textureWidth * textureY + textureX];
+			if (colormap != nullptr) {
+				textureColor = RGB(colormap[GetRValue(textureColor)], colormap[256 + GetGValue(textureColor)],
+				                   colormap[512 + GetBValue(textureColor)]);
+			}
+			Span.output[x] = (textureColor >> 1) & 8355711;
+		}
+	}
+
+	/**
+	 * 以毫秒为单位测量 Function 执行 Repeat 次中最快的一次
+	 */
+	template <class Function>
+	double Measure(const int &Repeat, Function &&Target) {
+		double best = 1e30;
+		for (int count = 0; count < Repeat; ++count) {
+			auto start = std::chrono::steady_clock::now();
+			Target();
+			auto end = std::chrono::steady_clock::now();
+			best     = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+		}
+
+		return best;
+	}
+
+	std::string DescribeColumnFeatures(const unsigned &Features) {
+		std::string text;
+		text += (Features & RCRender::ColumnFeature::Fog) != 0 ? "fog " : "";
+		text += (Features & RCRender::ColumnFeature::Blend) != 0 ? "blend " : "";
+		text += (Features >> 2) == 1 ? "NS" : ((Features >> 2) == 2 ? "diagonal" : "EW");
+
+		return text;
+	}
+}
+
+int main(int argc, char **argv) {
+	const int repeat  = argc > 1 ? std::atoi(argv[1]) : 20;
+	const int width   = 1920;
+	const int height  = 1080;
+	const int texture = 256;
+
+	std::mt19937 random(1);
+	// 纹理中约八分之一的纹素是透明的，与门、栅栏的纹理相近
+	std::vector<DWORD> texels(texture * texture);
+	for (auto &texel : texels) {
+		texel = (random() % 8 == 0 ? 0 : 0xFF000000) | (random() & 0xFFFFFF);
+	}
+	// 一张中等浓度的烟雾颜色表
+	std::vector<BYTE> colormap(768 + 4);
+	for (int channel = 0; channel < 3; ++channel) {
+		for (int value = 0; value < 256; ++value) {
+			colormap[channel * 256 + value] = static_cast<BYTE>(value * 0.6f + 40.f);
+		}
+	}
+
+	std::vector<DWORD> generic(width * height);
+	std::vector<DWORD> specialized(width * height);
+	// 输出与通用实现不一致的组合数量
+	int                failures = 0;
+
+	std::cout << std::format("{} repeats, {}x{}\n", repeat, width, height);
+	std::cout << std::format("{:<32}{:>16}{:>16}{:>10}\n", "column features", "generic ms", "specialized ms", "match");
+
+	// 每一列都是一面占满屏幕高度的墙，纹理从第 x % texture 列读取
+	auto makeColumn = [&](std::vector<DWORD> &Target, const int &X) {
+		RCRender::ColumnSpan span{};
+		span.texels       = texels.data() + X % texture;
+		span.texelStride  = texture;
+		span.textureY     = 0;
+		span.stepper      = RCRender::MakeTextureStepper(0, 0, texture, height);
+		span.colormap     = colormap.data();
+		span.output       = Target.data() + X;
+		span.outputStride = width;
+		span.begin        = 0;
+		span.end          = height;
+
+		return span;
+	};
+	for (unsigned features = 0; features < RCRender::ColumnFeature::Count; ++features) {
+		const auto kernel = RCRender::GetColumnKernel(features);
+		std::fill(generic.begin(), generic.end(), 0x404040);
+		std::fill(specialized.begin(), specialized.end(), 0x404040);
+
+		const double genericTime = Measure(repeat, [&]() {
+			for (int x = 0; x < width; ++x) {
+				RenderColumnGeneric(makeColumn(generic, x), features);
+			}
+		});
+		const double specializedTime = Measure(repeat, [&]() {
+			for (int x = 0; x < width; ++x) {
+				kernel(makeColumn(specialized, x));
+			}
+		});
+
+		failures += generic == specialized ? 0 : 1;
+		std::cout << std::format("{:<32}{:>16.3f}{:>16.3f}{:>10}\n", DescribeColumnFeatures(features), genericTime,
+		                         specializedTime, generic == specialized ? "yes" : "NO");
+	}
+
+	// 行扫描内核的基准为通用的标量实现，同一行上各指令集的特化实现均与其比较
+	std::cout << std::format("\n{:<32}{:>20}{:>16}{:>10}\n", "floor features / instruction set", "generic scalar ms",
+	                         "specialized ms", "match");
+	const RCRender::InstructionSet sets[] = { RCRender::InstructionSet::Scalar, RCRender::InstructionSet::SSE41,
+	                                          RCRender::InstructionSet::AVX2 };
+	const char                    *names[] = { "scalar", "sse4.1", "avx2" };
+	for (unsigned features = 0; features < RCRender::FloorFeature::Count; ++features) {
+		for (int set = 0; set < 3; ++set) {
+			if (sets[set] > RCRender::DetectInstructionSet()) {
+				continue;
+			}
+			const auto kernel = RCRender::GetFloorSpanKernel(sets[set], features);
+
+			// 每一行的距离随行号变化，与地板的透视一致
+			auto makeSpan = [&](std::vector<DWORD> &Target, const int &Y) {
+				const float distance = static_cast<float>(height) / static_cast<float>(2 * (Y % (height / 2)) + 2);
+
+				RCRender::FloorSpan span{};
+				span.texture       = texels.data();
+				span.textureWidth  = texture;
+				span.textureHeight = texture;
+				span.positionX     = 32.5f - distance;
+				span.positionY     = 32.5f + distance;
+				span.stepX         = 2.f * distance / static_cast<float>(width);
+				span.stepY         = 0.3f * distance / static_cast<float>(width);
+				span.colormap      = colormap.data();
+				span.saturated     = false;
+				span.output        = Target.data() + Y * width;
+				span.begin         = 0;
+				span.end           = width;
+
+				return span;
+			};
+			const double genericTime = Measure(repeat, [&]() {
+				for (int y = 0; y < height; ++y) {
+					RenderFloorSpanGeneric(makeSpan(generic, y), features);
+				}
+			});
+			const double specializedTime = Measure(repeat, [&]() {
+				for (int y = 0; y < height; ++y) {
+					kernel(makeSpan(specialized, y));
+				}
+			});
+
+			const std::string description = std::format("{}{}/ {}", (features & RCRender::FloorFeature::Ceiling) != 0 ? "ceiling " : "floor ",
+			                                            (features & RCRender::FloorFeature::Fog) != 0 ? "fog " : "", names[set]);
+			failures += generic == specialized ? 0 : 1;
+			std::cout << std::format("{:<32}{:>20.3f}{:>16.3f}{:>10}\n", description, genericTime, specializedTime,
+			                         generic == specialized ? "yes" : "NO");
+		}
+	}
+
+	return failures == 0 ? 0 : 1;
+}
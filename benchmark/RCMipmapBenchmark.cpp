@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2023~Now Margoo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * \file RCMipmapBenchmark.cpp
+ * \brief 在 1080p 下比较启用与禁用 mipmap 时渲染地板与天花板的耗时
+ */
+
+#include <include/RCRenderer.h>
+
+#include <chrono>
+#include <format>
+#include <iostream>
+#include <random>
+
+namespace {
+	/**
+	 * 生成一张随机噪声纹理，噪声纹理在远处最容易产生摩尔纹，也最能体现缓存缺失的代价
+	 */
+	RCTexture *CreateNoiseTexture(const int &Size, const unsigned &Seed) {
+		auto         context = new RCContext(Size, Size);
+		auto         buffer  = context->GetBuffer();
+		std::mt19937 random(Seed);
+		for (int position = 0; position < Size * Size; ++position) {
+			buffer[position] = 0xFF000000 | (random() & 0xFFFFFF);
+		}
+
+		return new RCTexture(context);
+	}
+	/**
+	 * 生成一张只有四周为墙的开阔地图，画面的大部分将是地板与天花板
+	 */
+	RCMap *CreateOpenMap(const int &Size, RCTexture *WallTexture) {
+		auto units = new RCMapUnit[Size * Size];
+		for (int y = 0; y < Size; ++y) {
+			for (int x = 0; x < Size; ++x) {
+				auto &unit   = units[x + y * Size];
+				unit.Texture = nullptr;
+				unit.Type    = RCMapUnitType::Air;
+				if (x == 0 || y == 0 || x == Size - 1 || y == Size - 1) {
+					unit.Texture = WallTexture;
+					unit.Type    = RCMapUnitType::Wall;
+				}
+			}
+		}
+
+		return new RCMap(Size, Size, units);
+	}
+
+	/**
+	 * 让相机在地图中央旋转一周，返回平均每帧的耗时（毫秒）
+	 */
+	double RenderFrames(RCRenderer &Renderer, RCCamera &Camera, const int &FrameCount, const float &Center) {
+		auto start = std::chrono::steady_clock::now();
+		for (int frame = 0; frame < FrameCount; ++frame) {
+			const float angle = 6.2831853f * static_cast<float>(frame) / static_cast<float>(FrameCount);
+
+			Camera.Position  = vecmath::Vector<float>(Center, Center, 0);
+			Camera.Direction = vecmath::Vector<float>(std::cos(angle), std::sin(angle), 0);
+			Camera.Plane     = vecmath::Vector<float>(-std::sin(angle) * 0.66f, std::cos(angle) * 0.66f, 0);
+			Renderer.Render();
+		}
+		auto end = std::chrono::steady_clock::now();
+
+		return std::chrono::duration<double, std::milli>(end - start).count() / FrameCount;
+	}
+}
+
+int main(int argc, char **argv) {
+	const int textureSize = argc > 1 ? std::atoi(argv[1]) : 256;
+	const int frameCount  = argc > 2 ? std::atoi(argv[2]) : 120;
+	const int mapSize     = 128;
+
+	auto floorTexture   = CreateNoiseTexture(textureSize, 1);
+	auto ceilingTexture = CreateNoiseTexture(textureSize, 2);
+	auto wallTexture    = CreateNoiseTexture(textureSize, 3);
+	auto map            = CreateOpenMap(mapSize, wallTexture);
+
+	RCScene scene(map);
+	scene.SpriteList  = nullptr;
+	scene.SpriteCount = 0;
+	scene.SetFloorTexture(floorTexture);
+	scene.SetCeilingTexture(ceilingTexture);
+
+	RCContext      context(1920, 1080);
+	RCRenderTarget renderTarget(&context);
+	RCCamera       camera(vecmath::Vector<float>(mapSize / 2.f, mapSize / 2.f, 0), vecmath::Vector<float>(1, 0, 0), 1.15f);
+	RCRenderer     renderer(&renderTarget, &camera, &scene);
+	renderer.EnableSuperResolution(false);
+
+	std::cout << std::format("1920x1080, {}x{} textures, {} mip levels, {} frames\n", textureSize, textureSize,
+	                         floorTexture->GetMipLevelCount(), frameCount);
+
+	// 先渲染几帧预热缓存与线程池
+	RenderFrames(renderer, camera, 4, mapSize / 2.f);
+
+	renderer.EnableMipmap(false);
+	const double withoutMipmap = RenderFrames(renderer, camera, frameCount, mapSize / 2.f);
+	renderer.EnableMipmap(true);
+	const double withMipmap = RenderFrames(renderer, camera, frameCount, mapSize / 2.f);
+
+	std::cout << std::format("{:<16}{:>16}\n", "mode", "ms/frame");
+	std::cout << std::format("{:<16}{:>16.2f}\n", "without mipmap", withoutMipmap);
+	std::cout << std::format("{:<16}{:>16.2f}\n", "with mipmap", withMipmap);
+
+	delete map;
+
+	return 0;
+}
@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2023~Now Margoo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/**
+ * \file RCPerfCounters.h
+ * \brief 基于 Linux perf_event_open 的硬件性能计数器，供性能测试按渲染阶段统计周期、指令、缓存与分支预测的失效次数
+ *
+ * 每个线程在第一次读取时打开本线程的计数器组，之后每次读取只需一次 read 调用；
+ * 在其它平台、内核禁止访问性能计数器或虚拟机未提供 PMU 时，IsAvailable 返回 false
+ */
+
+#pragma once
+
+#include <include/RCProfiler.h>
+
+#include <array>
+#include <cstdint>
+
+#ifdef __linux__
+#	include <linux/perf_event.h>
+#	include <sys/syscall.h>
+#	include <unistd.h>
+#endif
+
+namespace RCBench {
+	/**
+	 * 性能测试统计的硬件性能计数器
+	 */
+	enum class PerfCounter { Cycles, Instructions, L1DataMisses, LastLevelCacheMisses, BranchMisses };
+	constexpr int PerfCounterCount = 5;
+
+	inline const char *GetPerfCounterName(const PerfCounter &Counter) {
+		constexpr const char *names[PerfCounterCount] = { "cycles", "instructions", "l1d_misses", "llc_misses",
+		                                                  "branch_misses" };
+		return names[static_cast<int>(Counter)];
+	}
+
+	class PerfCounters : public RCProfileCounters {
+	public:
+		/**
+		 * 在调用线程上尝试打开计数器，以确定哪些计数器可用
+		 */
+		PerfCounters() : _available{} {
+#ifdef __linux__
+			auto &group = GetThreadGroup();
+			for (int counter = 0; counter < PerfCounterCount; ++counter) {
+				_available[counter] = group.slot[counter] >= 0;
+			}
+#endif
+		}
+
+	public:
+		/**
+		 * 是否至少有一个计数器可用
+		 */
+		[[nodiscard]] bool IsAvailable() const {
+			for (auto available : _available) {
+				if (available) {
+					return true;
+				}
+			}
+
+			return false;
+		}
+		/**
+		 * 某一计数器是否可用，不可用的计数器读取的值总为 0
+		 */
+		[[nodiscard]] bool IsAvailable(const PerfCounter &Counter) const {
+			return _available[static_cast<int>(Counter)];
+		}
+		[[nodiscard]] int GetCounterCount() const override {
+			return PerfCounterCount;
+		}
+		void Read(long long *Values) override {
+			for (int counter = 0; counter < PerfCounterCount; ++counter) {
+				Values[counter] = 0;
+			}
+#ifdef __linux__
+			auto &group = GetThreadGroup();
+			if (group.leader < 0) {
+				return;
+			}
+			// PERF_FORMAT_GROUP 的格式为计数器的个数，其后依次为组长与各成员的值
+			std::uint64_t buffer[PerfCounterCount + 1];
+			if (read(group.leader, buffer, sizeof(buffer)) <= 0) {
+				return;
+			}
+			for (int counter = 0; counter < PerfCounterCount; ++counter) {
+				if (group.slot[counter] >= 0 && static_cast<std::uint64_t>(group.slot[counter]) < buffer[0]) {
+					Values[counter] = static_cast<long long>(buffer[group.slot[counter] + 1]);
+				}
+			}
+#endif
+		}
+
+	private:
+#ifdef __linux__
+		/**
+		 * 一个线程的计数器组，slot 为各计数器在组内的位置，未能打开的计数器为 -1
+		 */
+		struct ThreadGroup {
+			int                                 leader = -1;
+			std::array<int, PerfCounterCount>   descriptors{ -1, -1, -1, -1, -1 };
+			std::array<int, PerfCounterCount>   slot{ -1, -1, -1, -1, -1 };
+
+			ThreadGroup() {
+				constexpr std::uint64_t cacheReadMiss =
+				    (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+				const std::uint32_t types[PerfCounterCount]  = { PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE,
+				                                                 PERF_TYPE_HW_CACHE, PERF_TYPE_HW_CACHE,
+				                                                 PERF_TYPE_HARDWARE };
+				const std::uint64_t configs[PerfCounterCount] = {
+					PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_L1D | cacheReadMiss,
+					PERF_COUNT_HW_CACHE_LL | cacheReadMiss, PERF_COUNT_HW_BRANCH_MISSES
+				};
+
+				int members = 0;
+				for (int counter = 0; counter < PerfCounterCount; ++counter) {
+					perf_event_attr attribute{};
+					attribute.size           = sizeof(attribute);
+					attribute.type           = types[counter];
+					attribute.config         = configs[counter];
+					attribute.read_format    = PERF_FORMAT_GROUP;
+					attribute.exclude_kernel = 1;
+					attribute.exclude_hv     = 1;
+					// 只统计调用线程，在任意 CPU 上
+					const int descriptor = static_cast<int>(syscall(SYS_perf_event_open, &attribute, 0, -1, leader, 0));
+					if (descriptor < 0) {
+						continue;
+					}
+					if (leader < 0) {
+						leader = descriptor;
+					}
+					descriptors[counter] = descriptor;
+					slot[counter]        = members++;
+				}
+			}
+			~ThreadGroup() {
+				for (auto descriptor : descriptors) {
+					if (descriptor >= 0) {
+						close(descriptor);
+					}
+				}
+			}
+
+			ThreadGroup(const ThreadGroup &)            = delete;
+			ThreadGroup &operator=(const ThreadGroup &) = delete;
+		};
+
+		static ThreadGroup &GetThreadGroup() {
+			thread_local ThreadGroup group;
+
+			return group;
+		}
+#endif
+
+	private:
+		std::array<bool, PerfCounterCount> _available;
+	};
+}
@@ -0,0 +1,327 @@
+/*
+ * Copyright (c) 2023~Now Margoo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/**
+ * \file RCRegressionBench.cpp
+ * \brief 渲染结果与性能的回归测试：将固定场景与相机位姿下的画面与存储的基准画面逐像素比较，
+ *        并将各场景的帧时间与同一台机器上记录的基线比较
+ */
+
+#include <benchmark/RCBenchScene.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+namespace {
+	/**
+	 * 回归测试的渲染配置，golden 相同的配置应当渲染出相同的画面，因此共用同一组基准画面
+	 */
+	struct Configuration {
+		const char *name;
+		const char *golden;
+		int         threadCount;
+		bool        overdrawCulling;
+		float       renderScale;
+	};
+
+	const Configuration configurations[] = {
+		{ "default", "full", 1, false, 1.f },
+		{ "culling", "full", 1, true, 1.f },
+		{ "threads", "full", 3, false, 1.f },
+		{ "half_scale", "half", 1, false, 0.5f },
+	};
+
+	constexpr int GoldenWidth    = 320;
+	constexpr int GoldenHeight   = 240;
+	constexpr int PathFrameCount = 120;
+	// 每个场景在路径上均匀选取的位姿数
+	constexpr int PoseCount      = 4;
+	constexpr int PerfWidth      = 640;
+	constexpr int PerfHeight     = 480;
+	// 帧时间取多次测量中位数的最小值，以排除调度等偶发干扰
+	constexpr int PerfRepeats    = 5;
+	// 超出阈值时重新测量的次数，真正的性能退化在每次测量中都会复现
+	constexpr int PerfRetries    = 3;
+
+	std::string GetGoldenPath(const std::string &Directory, const std::string &Scene, const char *Golden,
+	                          const int &Pose) {
+		return std::format("{}/{}_{}_{}.ppm", Directory, Scene, Golden, Pose);
+	}
+	/**
+	 * 以二进制 PPM（P6）格式保存画布，透明度通道不会被保存
+	 */
+	bool WritePPM(const std::string &Path, const RCContext &Context) {
+		std::ofstream stream(Path, std::ios::binary);
+		stream << std::format("P6\n{} {}\n255\n", Context.GetWidth(), Context.GetHeight());
+		const auto buffer = Context.GetBuffer();
+		for (int position = 0; position < Context.GetWidth() * Context.GetHeight(); ++position) {
+			const char pixel[3] = { static_cast<char>(buffer[position] >> 16), static_cast<char>(buffer[position] >> 8),
+			                        static_cast<char>(buffer[position]) };
+			stream.write(pixel, 3);
+		}
+
+		return static_cast<bool>(stream);
+	}
+	/**
+	 * 读取由 WritePPM 保存的图片，像素以 0x00RRGGBB 格式储存
+	 */
+	bool ReadPPM(const std::string &Path, int &Width, int &Height, std::vector<DWORD> &Pixels) {
+		std::ifstream stream(Path, std::ios::binary);
+		std::string   magic;
+		int           maxValue = 0;
+		if (!(stream >> magic >> Width >> Height >> maxValue) || magic != "P6" || maxValue != 255) {
+			return false;
+		}
+		stream.get();
+
+		Pixels.resize(static_cast<size_t>(Width) * Height);
+		for (auto &pixel : Pixels) {
+			unsigned char channels[3];
+			if (!stream.read(reinterpret_cast<char *>(channels), 3)) {
+				return false;
+			}
+			pixel = (channels[0] << 16) | (channels[1] << 8) | channels[2];
+		}
+
+		return true;
+	}
+
+	/**
+	 * 以指定的配置渲染场景在各位姿下的画面，每个位姿渲染完成后调用 Callback(位姿下标, 画布)
+	 */
+	template <class Function>
+	void RenderPoses(RCBench::BenchScene &Scene, const RCBench::Textures &Textures,
+	                 const Configuration &Configuration, Function &&Callback) {
+		RCScene scene(Scene.map);
+		RCBench::SetupScene(scene, Scene, Textures);
+
+		RCContext      context(GoldenWidth, GoldenHeight);
+		RCRenderTarget renderTarget(&context);
+		RCCamera       camera(Scene.path.front(), vecmath::Vector<float>(1, 0, 0), 1.15f);
+		RCRenderer     renderer(&renderTarget, &camera, &scene);
+		renderer.SetRenderScale(Configuration.renderScale);
+		renderer.SetThreadCount(Configuration.threadCount);
+		renderer.EnableOverdrawCulling(Configuration.overdrawCulling);
+		for (int pose = 0; pose < PoseCount; ++pose) {
+			const int frame = pose * PathFrameCount / PoseCount;
+			RCBench::SetCameraPose(camera, Scene, frame, PathFrameCount);
+			RCBench::AnimateDoors(Scene, frame);
+			renderer.Render();
+
+			Callback(pose, context);
+		}
+	}
+	/**
+	 * 沿路径渲染一周，返回每帧耗时的中位数（毫秒）
+	 */
+	double MeasureFrameTime(RCBench::BenchScene &Scene, const RCBench::Textures &Textures) {
+		RCScene scene(Scene.map);
+		RCBench::SetupScene(scene, Scene, Textures);
+
+		RCContext      context(PerfWidth, PerfHeight);
+		RCRenderTarget renderTarget(&context);
+		RCCamera       camera(Scene.path.front(), vecmath::Vector<float>(1, 0, 0), 1.15f);
+		RCRenderer     renderer(&renderTarget, &camera, &scene);
+		renderer.EnableSuperResolution(false);
+
+		// 先渲染几帧预热缓存
+		for (int frame = 0; frame < 4; ++frame) {
+			RCBench::SetCameraPose(camera, Scene, frame, PathFrameCount);
+			renderer.Render();
+		}
+		renderer.GetProfiler().SetCapacity(PathFrameCount);
+		for (int frame = 0; frame < PathFrameCount; ++frame) {
+			RCBench::SetCameraPose(camera, Scene, frame, PathFrameCount);
+			RCBench::AnimateDoors(Scene, frame);
+			renderer.Render();
+		}
+		renderer.GetProfiler().CommitFrame();
+
+		return renderer.GetProfiler().GetPercentile(RCProfileStage::Frame, 50);
+	}
+	/**
+	 * 重复测量 PerfRepeats 次，返回其中最小的帧时间（毫秒）
+	 */
+	double MeasureBestFrameTime(RCBench::BenchScene &Scene, const RCBench::Textures &Textures) {
+		double best = MeasureFrameTime(Scene, Textures);
+		for (int repeat = 1; repeat < PerfRepeats; ++repeat) {
+			best = std::min(best, MeasureFrameTime(Scene, Textures));
+		}
+
+		return best;
+	}
+
+	int Record(const std::string &Directory) {
+		std::error_code error;
+		std::filesystem::create_directories(Directory, error);
+
+		const auto textures = RCBench::CreateTextures();
+		auto       scenes   = RCBench::CreateScenes(textures);
+		int        failures = 0;
+		for (auto &scene : scenes) {
+			std::vector<std::string> recorded;
+			for (const auto &configuration : configurations) {
+				// 共用基准画面的配置只由第一个配置记录
+				if (std::find(recorded.begin(), recorded.end(), configuration.golden) != recorded.end()) {
+					continue;
+				}
+				recorded.emplace_back(configuration.golden);
+
+				RenderPoses(scene, textures, configuration, [&](const int &Pose, const RCContext &Context) {
+					const auto path = GetGoldenPath(Directory, scene.name, configuration.golden, Pose);
+					if (!WritePPM(path, Context)) {
+						std::cout << std::format("FAIL cannot write {}\n", path);
+						++failures;
+					}
+				});
+			}
+		}
+
+		std::ofstream baseline(Directory + "/baseline.csv");
+		baseline << "scene,width,height,frameTimeMs\n";
+		for (auto &scene : scenes) {
+			const double frameTime = MeasureBestFrameTime(scene, textures);
+			baseline << std::format("{},{},{},{:.4f}\n", scene.name, PerfWidth, PerfHeight, frameTime);
+			std::cout << std::format("recorded {:<16}{:>10.3f} ms\n", scene.name, frameTime);
+		}
+		if (!baseline) {
+			std::cout << std::format("FAIL cannot write {}/baseline.csv\n", Directory);
+			++failures;
+		}
+
+		return failures == 0 ? 0 : 1;
+	}
+	int Check(const std::string &Directory, const int &Tolerance, const double &Threshold) {
+		const auto textures = RCBench::CreateTextures();
+		auto       scenes   = RCBench::CreateScenes(textures);
+		int        failures = 0;
+		for (auto &scene : scenes) {
+			for (const auto &configuration : configurations) {
+				RenderPoses(scene, textures, configuration, [&](const int &Pose, const RCContext &Context) {
+					const auto         path = GetGoldenPath(Directory, scene.name, configuration.golden, Pose);
+					int                width;
+					int                height;
+					std::vector<DWORD> golden;
+					if (!ReadPPM(path, width, height, golden) || width != Context.GetWidth() ||
+					    height != Context.GetHeight()) {
+						std::cout << std::format("FAIL {} {} pose {}: cannot read {}\n", scene.name, configuration.name,
+						                         Pose, path);
+						++failures;
+
+						return;
+					}
+
+					// 任一通道的差超过容差的像素视为不同
+					int differentPixels = 0;
+					int maxDifference   = 0;
+					for (int position = 0; position < width * height; ++position) {
+						const DWORD actual     = Context.GetBuffer()[position];
+						int         difference = 0;
+						for (const int shift : { 0, 8, 16 }) {
+							difference = std::max(difference, std::abs(static_cast<int>((actual >> shift) & 0xFF) -
+							                                           static_cast<int>((golden[position] >> shift) & 0xFF)));
+						}
+						maxDifference = std::max(maxDifference, difference);
+						if (difference > Tolerance) {
+							++differentPixels;
+						}
+					}
+					std::cout << std::format("{} {} {} pose {}: {} pixels differ, max channel difference {}\n",
+					                         differentPixels == 0 ? "PASS" : "FAIL", scene.name, configuration.name,
+					                         Pose, differentPixels, maxDifference);
+					failures += differentPixels == 0 ? 0 : 1;
+				});
+			}
+		}
+
+		std::ifstream                 baseline(Directory + "/baseline.csv");
+		std::map<std::string, double> baselineTime;
+		std::string                   line;
+		std::getline(baseline, line);
+		while (std::getline(baseline, line)) {
+			std::stringstream stream(line);
+			std::string       name;
+			std::string       field;
+			std::getline(stream, name, ',');
+			for (int column = 0; column < 3; ++column) {
+				std::getline(stream, field, ',');
+			}
+			baselineTime[name] = std::atof(field.c_str());
+		}
+		for (auto &scene : scenes) {
+			if (!baselineTime.contains(scene.name)) {
+				std::cout << std::format("FAIL {} perf: no baseline\n", scene.name);
+				++failures;
+				continue;
+			}
+
+			const double limit     = baselineTime[scene.name] * (1 + Threshold / 100);
+			double       frameTime = MeasureBestFrameTime(scene, textures);
+			for (int retry = 0; retry < PerfRetries && frameTime > limit; ++retry) {
+				frameTime = std::min(frameTime, MeasureBestFrameTime(scene, textures));
+			}
+			const bool   pass      = frameTime <= limit;
+			std::cout << std::format("{} {} perf: {:.3f} ms, baseline {:.3f} ms, limit {:.3f} ms\n",
+			                         pass ? "PASS" : "FAIL", scene.name, frameTime, baselineTime[scene.name], limit);
+			failures += pass ? 0 : 1;
+		}
+
+		std::cout << std::format("{} failure(s)\n", failures);
+
+		return failures == 0 ? 0 : 1;
+	}
+}
+
+int main(int argc, char **argv) {
+	if (argc < 3 || (std::string(argv[1]) != "record" && std::string(argv[1]) != "check")) {
+		std::cout << "usage: RCRegressionBench record <directory> [--if-missing]\n"
+		             "       RCRegressionBench check <directory> [pixel tolerance] [frame time threshold %]\n";
+
+		return 2;
+	}
+
+	const std::string directory = argv[2];
+	if (std::string(argv[1]) == "record") {
+		// 供 CTest 使用：目录中已有基线时保留，使其始终是第一次运行测试时的版本记录的
+		if (argc > 3 && std::string(argv[3]) == "--if-missing" &&
+		    std::filesystem::exists(directory + "/baseline.csv")) {
+			std::cout << std::format("keeping the existing reference in {}\n", directory);
+
+			return 0;
+		}
+
+		return Record(directory);
+	}
+
+	const int    tolerance = argc > 3 ? std::atoi(argv[3]) : 2;
+	const double threshold = argc > 4 ? std::atof(argv[4]) : 10.0;
+
+	return Check(directory, tolerance, threshold);
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2023~Now Margoo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/**
+ * \file RCSpanKernelCheck.cpp
+ * \brief 以随机生成的行检查各指令集、各特性组合的行扫描内核与标量实现的输出是否逐像素相同
+ */
+
+#include <include/RCSpanKernel.h>
+
+#include <cmath>
+#include <format>
+#include <iostream>
+#include <random>
+#include <vector>
+
+int main(int argc, char **argv) {
+	const int      spanCount = argc > 1 ? std::atoi(argv[1]) : 20000;
+	const unsigned seed      = argc > 2 ? static_cast<unsigned>(std::atoi(argv[2])) : 1;
+	// 输出行的长度，两端各留出一段哨兵，用于检查内核是否写出了 [begin, end) 之外
+	const int      width     = 1024;
+	const int      guard     = 16;
+	const DWORD    sentinel  = 0xA5A5A5A5;
+
+	std::mt19937 random(seed);
+	auto uniform = [&](const float &Min, const float &Max) {
+		return std::uniform_real_distribution<float>(Min, Max)(random);
+	};
+
+	// 纹理边长为 2 的幂，内核以按位与回绕纹理坐标
+	std::vector<std::vector<DWORD>> textures;
+	for (int size = 8; size <= 256; size *= 2) {
+		std::vector<DWORD> texture(size * size);
+		for (auto &texel : texture) {
+			texel = random();
+		}
+		textures.push_back(std::move(texture));
+	}
+	std::vector<BYTE> colormap(768 + 4);
+	for (auto &value : colormap) {
+		value = static_cast<BYTE>(random());
+	}
+
+	const RCRender::InstructionSet sets[]  = { RCRender::InstructionSet::Scalar, RCRender::InstructionSet::SSE41,
+	                                           RCRender::InstructionSet::AVX2 };
+	const char                    *names[] = { "scalar", "sse4.1", "avx2" };
+
+	std::vector<DWORD> reference(width + 2 * guard);
+	std::vector<DWORD> output(width + 2 * guard);
+	int                failures = 0;
+
+	std::cout << std::format("{} spans per combination, seed {}\n", spanCount, seed);
+	std::cout << std::format("{:<24}{:<10}{:>12}\n", "floor features", "set", "mismatches");
+	for (unsigned features = 0; features < RCRender::FloorFeature::Count; ++features) {
+		const std::string description = std::format("{}{}", (features & RCRender::FloorFeature::Ceiling) != 0 ? "ceiling" : "floor",
+		                                            (features & RCRender::FloorFeature::Fog) != 0 ? " fog" : "");
+		const auto scalar = RCRender::GetFloorSpanKernel(RCRender::InstructionSet::Scalar, features);
+		for (int set = 0; set < 3; ++set) {
+			if (sets[set] > RCRender::DetectInstructionSet()) {
+				std::cout << std::format("{:<24}{:<10}{:>12}\n", description, names[set], "skipped");
+				continue;
+			}
+			const auto kernel = RCRender::GetFloorSpanKernel(sets[set], features);
+
+			std::mt19937 spanRandom(seed + features * 3 + set);
+			random.seed(spanRandom());
+			int mismatches = 0;
+			for (int count = 0; count < spanCount; ++count) {
+				const auto &texture = textures[random() % textures.size()];
+				const int   size    = static_cast<int>(std::sqrt(static_cast<double>(texture.size())));
+
+				RCRender::FloorSpan span{};
+				span.texture       = texture.data();
+				span.textureWidth  = size;
+				span.textureHeight = size;
+				// 起点可能位于地图之外，步长覆盖从近处到远处的各种距离
+				span.positionX     = uniform(-8.f, 72.f);
+				span.positionY     = uniform(-8.f, 72.f);
+				span.stepX         = uniform(-0.1f, 0.1f);
+				span.stepY         = uniform(-0.1f, 0.1f);
+				span.colormap      = colormap.data();
+				span.saturated     = random() % 8 == 0;
+				span.fogColor      = random() & 0xFFFFFF;
+				span.begin         = static_cast<int>(random() % width);
+				span.end           = span.begin + static_cast<int>(random() % (width - span.begin + 1));
+
+				std::fill(reference.begin(), reference.end(), sentinel);
+				std::fill(output.begin(), output.end(), sentinel);
+				span.output = reference.data() + guard;
+				scalar(span);
+				span.output = output.data() + guard;
+				kernel(span);
+
+				bool match = reference == output;
+				// 标量实现本身不能写出 [begin, end) 之外
+				for (int x = 0; x < width + 2 * guard && match; ++x) {
+					const bool inside = x >= guard + span.begin && x < guard + span.end;
+					match             = inside || reference[x] == sentinel;
+				}
+				if (!match) {
+					if (mismatches == 0) {
+						std::cout << std::format("  first mismatch: texture {}, position ({}, {}), step ({}, {}), "
+						                         "saturated {}, range [{}, {})\n",
+						                         size, span.positionX, span.positionY, span.stepX, span.stepY,
+						                         span.saturated, span.begin, span.end);
+					}
+					++mismatches;
+				}
+			}
+
+			std::cout << std::format("{:<24}{:<10}{:>12}\n", description, names[set], mismatches);
+			failures += mismatches;
+		}
+	}
+
+	std::cout << std::format("{} failure(s)\n", failures);
+
+	return failures == 0 ? 0 : 1;
+}
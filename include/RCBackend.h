@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2023~Now Margoo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * \file RCBackend.h
+ * \brief RC 引擎的渲染后端选择
+ *
+ * RC 引擎目前支持两种后端：
+ *  - EasyX 后端（_RC_BACKEND_EASYX_），画布为 EasyX 的 IMAGE，仅能在 Windows 下使用
+ *  - 无头后端（_RC_BACKEND_HEADLESS_），画布为引擎自行管理的 32 位像素缓冲区，
+ *    不依赖任何窗口与 GDI 调用，可用于没有显示设备的服务器
+ * 后端由 CMakeLists.txt 中的 RC_BACKEND 选项决定，若未指定则在 Windows 下使用 EasyX，
+ * 在其余平台使用无头后端
+ */
+
+#pragma once
+
+#if !defined(_RC_BACKEND_EASYX_) && !defined(_RC_BACKEND_HEADLESS_)
+#	ifdef _WIN32
+#		define _RC_BACKEND_EASYX_
+#	else
+#		define _RC_BACKEND_HEADLESS_
+#	endif
+#endif
+
+#if defined(_RC_BACKEND_EASYX_) && defined(_RC_BACKEND_HEADLESS_)
+#	error "RCEngine : only one render backend can be selected"
+#endif
+
+#ifdef _RC_BACKEND_EASYX_
+#	include <graphics.h>
+#else
+#	include <cstdint>
+
+// 无头后端下不存在 Windows 头文件，在此提供渲染器所需的最小类型与宏定义，
+// 其语义与 Windows SDK 中的定义保持一致
+using BYTE     = std::uint8_t;
+using WORD     = std::uint16_t;
+using DWORD    = std::uint32_t;
+using COLORREF = DWORD;
+using TCHAR    = char;
+
+#	ifndef _T
+#		define _T(x) x
+#	endif
+
+#	define RGB(r, g, b) ((COLORREF)(((BYTE)(r) | ((WORD)((BYTE)(g)) << 8)) | (((DWORD)(BYTE)(b)) << 16)))
+#	define GetRValue(rgb) ((BYTE)(rgb))
+#	define GetGValue(rgb) ((BYTE)(((WORD)(rgb)) >> 8))
+#	define GetBValue(rgb) ((BYTE)((rgb) >> 16))
+#	define BGR(color) ((((color) & 0xFF) << 16) | ((color) & 0xFF00FF00) | (((color) & 0xFF0000) >> 16))
+
+// 调试信息依赖 EasyX 的文字输出，无头后端下不可用
+#	undef _RC_RENDER_DEBUGER_
+#endif
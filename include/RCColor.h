@@ -27,8 +27,8 @@
 
 #pragma once
 
+#include <include/RCBackend.h>
 #include <include/RCException.h>
-#include <graphics.h>
 
 /**
  * 对颜色的封装，该类会将 R、G、B 三通道分开保存
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2023~Now Margoo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * \file RCColumnKernel.h
+ * \brief 墙体与精灵的列内核，按特性位特化为互不相同的实例，内层循环不含特性判断
+ */
+
+#pragma once
+
+#include <include/RCSpanKernel.h>
+
+namespace RCRender {
+	/**
+	 * 屏幕列上纹理纵坐标的 32.32 定点数步进器，每个像素只需一次加法与一次移位
+	 */
+	struct TextureStepper {
+		// 下一个像素的纹理纵坐标
+		long long position;
+		// 每个像素的纹理纵坐标增量
+		long long step;
+	};
+	/**
+	 * 构造纹理步进器，第一个像素之后的纹理纵坐标与逐像素累加 TextureHeight、
+	 * 超过 DeltaY 时纹理纵坐标加一的整数算法一致。精确值的小数部分要么为零，要么不小于 1 / DeltaY，
+	 * 因此起点额外加上不足 1 / DeltaY 的偏置以抵消起点与步长的截断误差。第 n 个像素的误差小于 (n + 1) / 2^32，
+	 * 只要 (n + 1) * DeltaY 不超过 2^32 结果就逐像素相同，即 DeltaY 不超过 65535 的列总是与整数算法一致
+	 * @param TextureY 第一个像素（裁剪后）的纹理纵坐标
+	 * @param Count 第一个像素（裁剪后）的累加余数
+	 * @param TextureHeight 纹理高度
+	 * @param DeltaY 该列在屏幕上的高度
+	 * @return 指向第二个像素的纹理步进器
+	 */
+	inline TextureStepper MakeTextureStepper(const int &TextureY, const int &Count, const int &TextureHeight,
+	                                         const int &DeltaY) {
+		constexpr int       fractionBits = 32;
+		constexpr long long fractionMask = (1LL << fractionBits) - 1;
+		if (DeltaY <= 0) {
+			return { static_cast<long long>(TextureY) << fractionBits, 0 };
+		}
+		const long long total = static_cast<long long>(TextureY) * DeltaY + Count + TextureHeight - 1;
+		// 分别求整数与小数部分，total 左移 32 位可能溢出
+		const long long start = ((total / DeltaY) << fractionBits) + ((total % DeltaY) << fractionBits) / DeltaY;
+
+		return { start + fractionMask / DeltaY, (static_cast<long long>(TextureHeight) << fractionBits) / DeltaY };
+	}
+	/**
+	 * 定点数纹理坐标的整数部分
+	 */
+	inline int GetStepperTexel(const long long &Position) {
+		return static_cast<int>(Position >> 32);
+	}
+	/**
+	 * 列内核的特性位。烟雾的特性每帧确定一次，混合与明暗面的特性由击中的物体决定，
+	 * 组合后的特性即为列内核表的下标
+	 */
+	namespace ColumnFeature {
+		// 通过烟雾颜色表处理颜色，此时 ColumnSpan::colormap 不能为 nullptr
+		constexpr unsigned Fog          = 1;
+		// 与输出中已有的颜色各取一半混合（玻璃）
+		constexpr unsigned Blend        = 2;
+		// 明暗面，各通道右移一位（NS 面）或两位（斜墙），两者互斥
+		constexpr unsigned ShadeHalf    = 1 << 2;
+		constexpr unsigned ShadeQuarter = 2 << 2;
+		// 特性组合的数量
+		constexpr unsigned Count        = 3 << 2;
+	}
+
+	/**
+	 * 屏幕上的一段列，第 y 个像素读取纹理的第 textureY 个纹素后，纹理纵坐标由 stepper 推进，
+	 * 内核渲染 [begin, end) 范围内的像素，透明（Alpha 为零）的纹素不写入
+	 */
+	struct ColumnSpan {
+		// 该列的第一个纹素，以及相邻纹素之间的距离
+		const DWORD   *texels;
+		int            texelStride;
+		// 第一个像素的纹理纵坐标，以及指向第二个像素的步进器
+		int            textureY;
+		TextureStepper stepper;
+		// 烟雾颜色表，依次为 R、G、B 三个通道各 256 项，仅在启用 ColumnFeature::Fog 时读取
+		const BYTE    *colormap;
+		// 输出列的第 0 个像素，以及相邻像素之间的距离
+		DWORD         *output;
+		int            outputStride;
+		int            begin;
+		int            end;
+	};
+	using ColumnKernel = void (*)(const ColumnSpan &Span);
+
+	/**
+	 * 获取指定特性组合的列内核
+	 * @param Features ColumnFeature 的组合，必须小于 ColumnFeature::Count
+	 * @return 列内核
+	 */
+	ColumnKernel GetColumnKernel(const unsigned &Features);
+}
@@ -27,17 +27,19 @@
 
 #pragma once
 
+#include <include/RCBackend.h>
 #include <include/RCException.h>
 
-#include <graphics.h>
-
 /**
- * 一个对 EasyX 的 IMAGE 包装类，用于描述画布。并添加了一些易于使用的 API
+ * 一个对画布的包装类，并添加了一些易于使用的 API。
+ * 在 EasyX 后端下包装 EasyX 的 IMAGE，在无头后端下则持有一块 32 位、
+ * 按 BufferAlignment 字节对齐的像素缓冲区
  */
 class RCContext {
 public:
 	/**
-	 * 默认将会创建一个代表当前窗口屏幕的 Context
+	 * 默认将会创建一个代表当前窗口屏幕的 Context，无头后端下
+	 * 不存在窗口，将会抛出 RCWindowHaveNotCreated 异常
 	 */
 	RCContext();
 	/**
@@ -47,20 +49,25 @@ public:
 	 */
 	RCContext(const int &Width, const int &Height);
 	/**
-	 * 从资源文件创建 Context
+	 * 从资源文件创建 Context，仅 EasyX 后端可用
 	 * @param ResourceType 资源类型
 	 * @param ResourceName 资源名称
 	 */
 	RCContext(const TCHAR *ResourceType, const TCHAR *ResourceName);
 	/**
 	 * 从图片文件创建 Context，注意，由于该构造函数依靠图片长宽是否
-	 * 等于零以判断是否成功加载文件，所以请不要传入长宽都为零的图片
+	 * 等于零以判断是否成功加载文件，所以请不要传入长宽都为零的图片。
+	 * 无头后端下仅支持二进制 PPM（P6）格式的图片
 	 * @param FilePath 指向受支持的图片文件路径
 	 */
 	explicit RCContext(const TCHAR *FilePath);
-	~RCContext() {
-		delete _context;
-	}
+	~RCContext();
+
+public:
+	/**
+	 * 无头后端下像素缓冲区的对齐字节数
+	 */
+	static constexpr int BufferAlignment = 64;
 
 public:
 	/**
@@ -73,6 +80,11 @@ public:
 	 * @return 该 Context 目前的高
 	 */
 	[[nodiscard]] int GetHeight() const;
+	/**
+	 * 获取 Context 的像素缓冲区，像素格式为 0xAARRGGBB，按行储存
+	 * @return 指向像素缓冲区的指针，注意 Resize 后该指针将会失效
+	 */
+	[[nodiscard]] DWORD *GetBuffer() const;
 
 public:
 	/**
@@ -88,5 +100,11 @@ private:
 	friend class RCRenderer;
 
 private:
+#ifdef _RC_BACKEND_EASYX_
 	IMAGE *_context;
+#else
+	DWORD *_buffer;
+	int    _width;
+	int    _height;
+#endif
 };
\ No newline at end of file
@@ -27,4 +27,11 @@
 
 #pragma once
 
-#include <include/RCInteractor.h>
\ No newline at end of file
+#include <include/RCBackend.h>
+#include <include/RCTrace.h>
+
+#ifdef _RC_BACKEND_EASYX_
+#include <include/RCInteractor.h>
+#else
+#include <include/RCRenderer.h>
+#endif
\ No newline at end of file
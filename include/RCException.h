@@ -34,10 +34,10 @@
 /**
  * RC 异常的基类
  */
-class RCException : std::exception {
+class RCException : std::runtime_error {
 public:
 	explicit RCException(const char *Message)
-	    : std::exception(std::format("RCEngine exception : {}.", Message).c_str()) {
+	    : std::runtime_error(std::format("RCEngine exception : {}.", Message)) {
 #ifdef _DEBUG
 		std::cerr << std::format("RCEngine exception : {}.", Message);
 #endif
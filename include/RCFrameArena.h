@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2023~Now Margoo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/**
+ * \file RCFrameArena.h
+ * \brief 渲染器使用的帧内存分配器
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+/**
+ * 按帧重置的线性（bump-pointer）内存分配器，用于存放一帧之内的临时数据（如击中列表与精灵列表）。
+ * 分配只需移动指针，不支持单独释放，所有内存在 Reset 时一并回收。
+ * 容量不足时会追加新的内存块，并在下一次 Reset 时合并为一块，因此稳定后每帧不会再向系统申请内存。
+ * 该分配器不是线程安全的，每个渲染线程应当持有自己的分配器
+ */
+class RCFrameArena {
+public:
+	/**
+	 * 内存块的对齐大小，与缓存行一致
+	 */
+	static constexpr size_t BlockAlignment = 64;
+	/**
+	 * 默认的初始内存块大小
+	 */
+	static constexpr size_t DefaultBlockSize = 64 * 1024;
+
+public:
+	/**
+	 * 创建一个帧内存分配器
+	 * @param BlockSize 初始内存块的大小（字节），必须大于零
+	 */
+	explicit RCFrameArena(const size_t &BlockSize = DefaultBlockSize);
+	~RCFrameArena();
+
+	RCFrameArena(const RCFrameArena &) = delete;
+	RCFrameArena &operator=(const RCFrameArena &) = delete;
+
+public:
+	/**
+	 * 分配 Count 个未初始化的对象，返回的内存在下一次 Reset 前有效
+	 * @param Count 对象的个数
+	 * @return 对象数组的首地址
+	 */
+	template <class Type>
+	[[nodiscard]] Type *Allocate(const size_t &Count) {
+		static_assert(std::is_trivially_copyable_v<Type> && std::is_trivially_destructible_v<Type>,
+		              "RCFrameArena : only trivial types can be allocated");
+		return static_cast<Type *>(AllocateBytes(Count * sizeof(Type), alignof(Type)));
+	}
+	/**
+	 * 将一个由 Allocate 分配的数组扩容至 NewCount 个对象，原有的 Count 个对象将被保留。
+	 * 若该数组是最近一次分配且当前内存块仍有空间，则原地扩容，否则重新分配并复制
+	 * @param Pointer 原数组的首地址
+	 * @param Count 原数组中对象的个数
+	 * @param NewCount 扩容后对象的个数
+	 * @return 扩容后数组的首地址
+	 */
+	template <class Type>
+	[[nodiscard]] Type *Grow(Type *Pointer, const size_t &Count, const size_t &NewCount) {
+		static_assert(std::is_trivially_copyable_v<Type> && std::is_trivially_destructible_v<Type>,
+		              "RCFrameArena : only trivial types can be allocated");
+		if (GrowInPlace(Pointer, Count * sizeof(Type), NewCount * sizeof(Type))) {
+			return Pointer;
+		}
+
+		auto result = Allocate<Type>(NewCount);
+		std::memcpy(result, Pointer, Count * sizeof(Type));
+
+		return result;
+	}
+	/**
+	 * 回收本帧分配的所有内存，之前分配的指针全部失效
+	 */
+	void Reset();
+	/**
+	 * 获取本帧已经分配的字节数
+	 * @return 已经分配的字节数
+	 */
+	[[nodiscard]] size_t GetUsedSize() const;
+	/**
+	 * 获取分配器当前持有的总字节数
+	 * @return 持有的总字节数
+	 */
+	[[nodiscard]] size_t GetCapacity() const;
+
+private:
+	void *AllocateBytes(const size_t &Size, const size_t &Alignment);
+	bool  GrowInPlace(void *Pointer, const size_t &Size, const size_t &NewSize);
+	void  AppendBlock(const size_t &Size);
+
+private:
+	struct Block {
+		unsigned char *memory;
+		size_t         size;
+	};
+
+	std::vector<Block> _blocks;
+	/**
+	 * 当前内存块中已使用的字节数
+	 */
+	size_t             _offset;
+	/**
+	 * 之前已经写满的内存块中使用的字节数
+	 */
+	size_t             _usedBefore;
+	/**
+	 * 最近一次分配的首地址，用于原地扩容
+	 */
+	unsigned char     *_lastAllocation;
+};
@@ -112,7 +112,7 @@ private:
 	void CheckMouse(const int &halfWidth, const int &halfHeight, const float &frameRate);
 
 private:
-	std::vector<RCMapUnit*>                     _inAnimationDoor;
+	std::vector<RCMapDoor*>                     _inAnimationDoor;
 	RCMap*                                      _map;
 	RCScene*                                    _scene;
 	RCCamera*                                   _camera;
@@ -29,6 +29,11 @@
 
 #include <include/RCTexture.h>
 
+#include <vecmath.hpp>
+
+#include <array>
+#include <cmath>
+#include <unordered_map>
 #include <vector>
 
 /**
@@ -59,7 +64,7 @@ private:
 /**
  * 地图单位的类型
  */
-enum class RCMapUnitType {
+enum class RCMapUnitType : unsigned char {
 	Air,  // 空气
 	Wall, // 厚墙
 	DiagWallLeftRight, // 45° 斜墙，从左上角到右下脚
@@ -70,7 +75,72 @@ enum class RCMapUnitType {
 };
 
 /**
- * 地图的单位
+ * 光线与地图单位相交的方式
+ */
+enum class RCMapUnitShape : unsigned char {
+	None,    // 不与光线相交
+	Block,   // 占据整个格子，光线在格子边界上击中
+	Thin,    // 位于格子中线上的薄片，光线在半格处击中
+	Diagonal // 沿格子对角线的斜墙
+};
+
+/**
+ * 地图单位类型的特性，光线投射与交互共用，新增单位类型时只需在 RCMapUnitTraitTable 中加入一行
+ */
+struct RCMapUnitTraits {
+	RCMapUnitType  type;
+	RCMapUnitShape shape;
+	// 斜墙的斜率，1 为从左上角到右下角，-1 为从右上角到左下角，其余形状为 0
+	signed char    slope;
+	// 击中后光线是否停止，门只有在完全关闭时才会挡住光线
+	bool           blocksRay;
+	// 渲染时是否需要与后方的物体进行透明度混合
+	bool           translucent;
+	// 是否带有可以开关的门
+	bool           door;
+	// 玩家是否可以通过
+	bool           passable;
+};
+
+/**
+ * 各地图单位类型的特性，按 RCMapUnitType 的顺序排列
+ */
+inline constexpr std::array<RCMapUnitTraits, 7> RCMapUnitTraitTable = { {
+	// 类型                             形状                      斜率 挡住光线 透明 门    可通过
+	{ RCMapUnitType::Air,               RCMapUnitShape::None,     0,  false, false, false, true  },
+	{ RCMapUnitType::Wall,              RCMapUnitShape::Block,    0,  true,  false, false, false },
+	{ RCMapUnitType::DiagWallLeftRight, RCMapUnitShape::Diagonal, 1,  false, false, false, false },
+	{ RCMapUnitType::DiagWallRightLeft, RCMapUnitShape::Diagonal, -1, false, false, false, false },
+	{ RCMapUnitType::Door,              RCMapUnitShape::Thin,     0,  true,  false, true,  false },
+	{ RCMapUnitType::Strip,             RCMapUnitShape::Thin,     0,  false, false, false, false },
+	{ RCMapUnitType::Glass,             RCMapUnitShape::Thin,     0,  false, true,  false, false }
+} };
+
+/**
+ * 检查特性表是否按照类型的顺序排列
+ */
+constexpr bool IsMapUnitTraitTableOrdered() {
+	for (std::size_t count = 0; count < RCMapUnitTraitTable.size(); ++count) {
+		if (static_cast<std::size_t>(RCMapUnitTraitTable[count].type) != count) {
+			return false;
+		}
+	}
+
+	return true;
+}
+static_assert(IsMapUnitTraitTableOrdered(), "RCMapUnitTraitTable must be indexed by RCMapUnitType");
+
+/**
+ * 获取地图单位类型的特性
+ * @param Type 单位的类型
+ * @return 该类型的特性
+ */
+constexpr const RCMapUnitTraits &GetMapUnitTraits(const RCMapUnitType &Type) {
+	return RCMapUnitTraitTable[static_cast<std::size_t>(Type)];
+}
+
+/**
+ * 地图的单位，地图内部并不以该结构体存储，该结构体仅用于构造地图与读写单个单位
  */
 struct RCMapUnit {
 	RCTexture       *Texture;
@@ -79,6 +149,189 @@ struct RCMapUnit {
 	bool             Passable   = false;
 };
 
+/**
+ * 在地图上逐格（DDA）步进的光线，渲染器与交互器共用。
+ * 光线第 n 次沿 X 方向步进后的距离为 originX + n * deltaDistanceX，而不是逐次累加得到，
+ * 因此借助距离场一次跳过多个格子与逐格步进的结果完全一致
+ */
+struct RCMapRay {
+public:
+	RCMapRay() = default;
+	/**
+	 * 从指定位置沿指定方向发出一条光线
+	 * @param Position 光线的起点
+	 * @param Direction 光线的方向
+	 */
+	RCMapRay(const vecmath::Vector<float> &Position, const vecmath::Vector<float> &Direction);
+
+public:
+	/**
+	 * 光线前进一格
+	 * @return 若沿 X 方向前进则返回 true，否则返回 false
+	 */
+	bool Step() {
+		if (sideDistanceX < sideDistanceY) {
+			++countX;
+			mapX          += stepX;
+			sideDistanceX  = SideDistanceX(countX);
+
+			return true;
+		} else {
+			++countY;
+			mapY          += stepY;
+			sideDistanceY  = SideDistanceY(countY);
+
+			return false;
+		}
+	}
+	/**
+	 * 跳过以当前格子为中心、半径为 Radius 的正方形空旷区域，光线将停在离开该区域之前的最后一格，
+	 * 其状态与逐格步进到该格时完全一致
+	 * @param Radius 空旷区域的半径（切比雪夫距离）
+	 */
+	void Skip(const int &Radius);
+	/**
+	 * 光线所在格子的入口是否已不近于指定距离，此时该格子及其后的物体与相机的距离均不小于 Distance
+	 * @param Distance 指定的距离
+	 * @return 若光线已越过该距离则返回 true，否则返回 false
+	 */
+	[[nodiscard]] bool IsBeyond(const float &Distance) const {
+		return sideDistanceX - deltaDistanceX >= Distance || sideDistanceY - deltaDistanceY >= Distance;
+	}
+	/**
+	 * 获取光线沿 X 方向第 Count 次步进后的距离
+	 */
+	[[nodiscard]] float SideDistanceX(const int &Count) const {
+		return Count == 0 ? originX : originX + static_cast<float>(Count) * deltaDistanceX;
+	}
+	/**
+	 * 获取光线沿 Y 方向第 Count 次步进后的距离
+	 */
+	[[nodiscard]] float SideDistanceY(const int &Count) const {
+		return Count == 0 ? originY : originY + static_cast<float>(Count) * deltaDistanceY;
+	}
+
+public:
+	int   mapX;
+	int   mapY;
+	int   stepX;
+	int   stepY;
+	// 已经沿 X、Y 方向步进的次数
+	int   countX;
+	int   countY;
+	// 光线到达第一条 X、Y 网格线的距离
+	float originX;
+	float originY;
+	float deltaDistanceX;
+	float deltaDistanceY;
+	float sideDistanceX;
+	float sideDistanceY;
+};
+
+/**
+ * 以 16.16 定点数逐格步进的光线，步进规则与 RCMapRay 相同，但只使用整数运算，
+ * 因此在不同的编译器与指令集下结果逐位相同。距离以 64 位整数保存，逐格累加不会产生误差，
+ * 借助距离场一次跳过多个格子与逐格步进的结果同样完全一致
+ */
+struct RCMapFixedRay {
+public:
+	/**
+	 * 定点数的小数位数与 1 的定点数表示
+	 */
+	static constexpr int       FractionBits = 16;
+	static constexpr long long One          = 1LL << FractionBits;
+	/**
+	 * 方向的某一分量为零（或极小）时，光线沿该方向前进一格所需的距离，足以越过任何地图
+	 */
+	static constexpr long long MaxDeltaDistance = 1LL << 40;
+
+public:
+	RCMapFixedRay() = default;
+	/**
+	 * 从指定位置沿指定方向发出一条光线
+	 * @param PositionX 起点的 X 坐标（定点数），需为正
+	 * @param PositionY 起点的 Y 坐标（定点数），需为正
+	 * @param DirectionX 方向的 X 分量（定点数）
+	 * @param DirectionY 方向的 Y 分量（定点数）
+	 * @param DeltaDistanceX 沿 X 方向前进一格时光线前进的距离，即 GetDeltaDistance(DirectionX)
+	 * @param DeltaDistanceY 沿 Y 方向前进一格时光线前进的距离，即 GetDeltaDistance(DirectionY)
+	 */
+	RCMapFixedRay(const int &PositionX, const int &PositionY, const int &DirectionX, const int &DirectionY,
+	              const long long &DeltaDistanceX, const long long &DeltaDistanceY);
+
+public:
+	/**
+	 * 将浮点数四舍五入为定点数
+	 */
+	[[nodiscard]] static int ToFixed(const float &Value) {
+		return static_cast<int>(std::lround(Value * static_cast<float>(One)));
+	}
+	/**
+	 * 将定点数转换为浮点数
+	 */
+	[[nodiscard]] static float ToFloat(const long long &Value) {
+		return static_cast<float>(Value) / static_cast<float>(One);
+	}
+	/**
+	 * 获取方向的分量为 Direction 时，光线沿该方向前进一格所需的距离，即 |1 / Direction|
+	 * @param Direction 方向的分量（定点数）
+	 * @return 前进一格所需的距离（定点数），不超过 MaxDeltaDistance
+	 */
+	[[nodiscard]] static long long GetDeltaDistance(const int &Direction) {
+		const long long magnitude = Direction < 0 ? -static_cast<long long>(Direction) : Direction;
+		if (magnitude == 0) {
+			return MaxDeltaDistance;
+		}
+		const long long distance = (One << FractionBits) / magnitude;
+
+		return distance < MaxDeltaDistance ? distance : MaxDeltaDistance;
+	}
+
+public:
+	/**
+	 * 光线前进一格
+	 * @return 若沿 X 方向前进则返回 true，否则返回 false
+	 */
+	bool Step() {
+		if (sideDistanceX < sideDistanceY) {
+			mapX          += stepX;
+			sideDistanceX += deltaDistanceX;
+
+			return true;
+		} else {
+			mapY          += stepY;
+			sideDistanceY += deltaDistanceY;
+
+			return false;
+		}
+	}
+	/**
+	 * 跳过以当前格子为中心、半径为 Radius 的正方形空旷区域，光线将停在离开该区域之前的最后一格，
+	 * 其状态与逐格步进到该格时完全一致
+	 * @param Radius 空旷区域的半径（切比雪夫距离）
+	 */
+	void Skip(const int &Radius);
+	/**
+	 * 光线所在格子的入口是否已不近于指定距离
+	 * @param Distance 指定的距离（定点数）
+	 * @return 若光线已越过该距离则返回 true，否则返回 false
+	 */
+	[[nodiscard]] bool IsBeyond(const long long &Distance) const {
+		return sideDistanceX - deltaDistanceX >= Distance || sideDistanceY - deltaDistanceY >= Distance;
+	}
+
+public:
+	int       mapX;
+	int       mapY;
+	int       stepX;
+	int       stepY;
+	// 光线沿 X、Y 方向前进一格所需的距离，以及到达下一条 X、Y 网格线的距离，均为定点数
+	long long deltaDistanceX;
+	long long deltaDistanceY;
+	long long sideDistanceX;
+	long long sideDistanceY;
+};
+
 /**
  * RC 引擎的地图，在 RC 引擎中，由于采用了 Ray Casting 的渲染方式，
  * 因此在 RC 引擎中地图其实是二维的，一个简单的 3x3 地图如下：
@@ -89,23 +342,96 @@ struct RCMapUnit {
 class RCMap {
 public:
 	/**
-	 * 地图的构建函数
+	 * 地图的构建函数，地图会将单位数组转换为内部的存储格式，并在转换后释放该数组
 	 * @param Width 地图的长
 	 * @param Height 地图的高
-	 * @param mapPointer 一个指向地图数组的指针
+	 * @param mapPointer 一个指向地图数组的指针，由 new[] 分配
 	 */
 	RCMap(const int &Width, const int &Height, RCMapUnit *MapPointer);
-	~RCMap() {
-		delete _mapArray;
-	}
 
 public:
 	/**
-	 * 获取地图指定下标的单位
+	 * 获取地图指定下标的单位。地图以结构数组的形式保存单位，返回的是一个只读的副本，
+	 * 过去通过返回的引用修改单位的代码将无法编译，应改为修改副本后调用 SetMapUnit：
+	 * 	RCMapUnit unit = map->GetMapUnit(position);
+	 * 	unit.Type      = RCMapUnitType::Wall;
+	 * 	map->SetMapUnit(position, unit);
+	 * @param Position 指定的下标
+	 * @return 地图单位的只读副本
+	 */
+	[[nodiscard]] const RCMapUnit GetMapUnit(const int &Position) const;
+	/**
+	 * 设置地图指定下标的单位，并更新距离场
+	 * @param Position 指定的下标
+	 * @param Unit 新的地图单位
+	 */
+	void SetMapUnit(const int &Position, const RCMapUnit &Unit);
+	/**
+	 * 获取地图指定下标的单位的类型
+	 * @param Position 指定的下标
+	 * @return 单位的类型
+	 */
+	[[nodiscard]] RCMapUnitType GetMapUnitType(const int &Position) const {
+		return static_cast<RCMapUnitType>(_typeArray[Position] & TypeMask);
+	}
+	/**
+	 * 获取地图指定下标的单位的纹理
+	 * @param Position 指定的下标
+	 * @return 单位的纹理
+	 */
+	[[nodiscard]] RCTexture *GetMapUnitTexture(const int &Position) const {
+		return _textureTable[_textureIndexArray[Position]];
+	}
+	/**
+	 * 获取地图指定下标的门
+	 * @param Position 指定的下标
+	 * @return 该单位的门，若该单位没有门则返回 nullptr
+	 */
+	[[nodiscard]] RCMapDoor *GetMapUnitDoor(const int &Position) const;
+	/**
+	 * 地图指定下标的单位是否可以通过
+	 * @param Position 指定的下标
+	 * @return 若可以通过则返回 true，否则返回 false
+	 */
+	[[nodiscard]] bool IsPassable(const int &Position) const {
+		return (_typeArray[Position] & PassableFlag) != 0;
+	}
+	/**
+	 * 获取指定单位到最近的非空气单位（地图之外也视为非空气）的切比雪夫距离，
+	 * 最大为 MaxEmptyDistance，非空气单位的距离为 0
+	 * @param Position 指定的下标
+	 * @return 切比雪夫距离
+	 */
+	[[nodiscard]] int GetEmptyDistance(const int &Position) const;
+	/**
+	 * 地图指定下标的单位是否为空气，只读取距离场，
+	 * 与 SkipEmptySpace 配合使用时光线投射每一步只需访问一个数组
 	 * @param Position 指定的下标
-	 * @return 一个指向地图单位的引用
+	 * @return 若为空气则返回 true，否则返回 false
 	 */
-	RCMapUnit& GetMapUnit(const int &Position);
+	[[nodiscard]] bool IsEmpty(const int &Position) const {
+		return _distanceField[Position] != 0;
+	}
+	/**
+	 * 借助距离场让光线跳过其所在格子周围的空旷区域
+	 * @param Ray 需要步进的光线
+	 */
+	void SkipEmptySpace(RCMapRay &Ray) const {
+		const int distance = _distanceField[Ray.mapX + Ray.mapY * _width];
+		if (distance > 1) {
+			Ray.Skip(distance - 1);
+		}
+	}
+	/**
+	 * 借助距离场让定点数光线跳过其所在格子周围的空旷区域
+	 * @param Ray 需要步进的光线
+	 */
+	void SkipEmptySpace(RCMapFixedRay &Ray) const {
+		const int distance = _distanceField[Ray.mapX + Ray.mapY * _width];
+		if (distance > 1) {
+			Ray.Skip(distance - 1);
+		}
+	}
 	/**
 	 * 获取地图的长
 	 * @return 地图的长
@@ -117,12 +443,70 @@ public:
 	 */
 	[[nodiscard]] int GetHeight() const;
 
+public:
+	/**
+	 * 距离场中记录的最大距离
+	 */
+	static constexpr int MaxEmptyDistance = 255;
+	/**
+	 * 地图中不同纹理的最大数量（包括空纹理）
+	 */
+	static constexpr int MaxTextureCount = 65536;
+
+private:
+	/**
+	 * 类型数组中每个字节的低 7 位为单位的类型，最高位为单位是否可以通过
+	 */
+	static constexpr unsigned char TypeMask     = 0x7F;
+	static constexpr unsigned char PassableFlag = 0x80;
+
+private:
+	/**
+	 * 将单位写入各个数组，不更新距离场
+	 */
+	void StoreMapUnit(const int &Position, const RCMapUnit &Unit);
+	/**
+	 * 获取纹理在纹理表中的下标，若纹理不在表中则加入纹理表
+	 */
+	unsigned short GetTextureIndex(RCTexture *Texture);
+	/**
+	 * 更新指定单位附近的距离场
+	 * @param Position 被修改的单位的下标
+	 */
+	void UpdateDistanceField(const int &Position);
+	/**
+	 * 重新计算矩形区域 [Left, Right] x [Top, Bottom] 内的距离场，区域之外的距离视为已知
+	 */
+	void RebuildDistanceField(const int &Left, const int &Top, const int &Right, const int &Bottom);
+
 private:
 	friend class RCRenderer;
 	friend class RCInteractor;
 
 private:
-	RCMapUnit  *_mapArray;
 	int         _width;
 	int         _height;
+	/**
+	 * 每个单位的类型与是否可以通过，光线投射时只需读取该数组
+	 */
+	std::vector<unsigned char>            _typeArray;
+	/**
+	 * 每个单位的纹理在 _textureTable 中的下标，下标 0 为空纹理
+	 */
+	std::vector<unsigned short>           _textureIndexArray;
+	std::vector<RCTexture *>              _textureTable;
+	std::unordered_map<RCTexture *, unsigned short> _textureIndexTable;
+	/**
+	 * 地图中的门，以单位的下标为键
+	 */
+	std::unordered_map<int, RCMapDoor *>  _doorTable;
+	/**
+	 * 每个单位到最近的非空气单位的切比雪夫距离，末尾另有 3 个字节的填充，
+	 * 以便光线包内核以 32 位为单位收集（gather）任意单位的距离
+	 */
+	std::vector<unsigned char>            _distanceField;
+	/**
+	 * 地图的版本号，每次修改单位时加一，渲染器借此判断是否可以沿用上一帧
+	 */
+	unsigned int                          _version;
 };
\ No newline at end of file
@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) 2023~Now Margoo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/**
+ * \file RCProfiler.h
+ * \brief 按渲染阶段统计耗时的帧分析器
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <ostream>
+#include <vector>
+
+/**
+ * 帧分析器统计的渲染阶段
+ */
+enum class RCProfileStage {
+	// 天空盒或天花板
+	SkyCeiling,
+	// 地板
+	Floor,
+	// 墙体求交（DDA）
+	WallTrace,
+	// 墙体着色，穿插在墙体之间的精灵列也在此阶段绘制
+	WallShading,
+	// 精灵的投影、排序与按列分组
+	Sprites,
+	// 内部分辨率画面的放大
+	Upscale,
+	// 将画布提交到窗口，由调用者在 Render 之后计时
+	Flush,
+	// RCRenderer::Render 的总耗时
+	Frame
+};
+
+/**
+ * 帧分析器统计的渲染阶段数
+ */
+constexpr int RCProfileStageCount = static_cast<int>(RCProfileStage::Frame) + 1;
+
+/**
+ * 一个渲染阶段在最近若干帧中的耗时统计（毫秒）
+ */
+struct RCProfileSummary {
+	double average;
+	double p50;
+	double p95;
+	double p99;
+	double max;
+};
+
+/**
+ * 渲染阶段的计数器来源（例如 CPU 的硬件性能计数器），设置到渲染器后，渲染器会在每个阶段的
+ * 开始与结束时在执行该阶段的线程上读取计数器，并将差值按阶段累加。实现需要分别统计调用 Read 的各个线程
+ */
+class RCProfileCounters {
+public:
+	/**
+	 * 计数器个数的上限
+	 */
+	static constexpr int MaxCounterCount = 8;
+
+public:
+	virtual ~RCProfileCounters() = default;
+
+public:
+	/**
+	 * 获取计数器的个数
+	 * @return 计数器的个数，不超过 MaxCounterCount
+	 */
+	[[nodiscard]] virtual int GetCounterCount() const = 0;
+	/**
+	 * 读取调用线程上各计数器的当前值
+	 * @param Values 存放计数器的值的数组，长度为 GetCounterCount()
+	 */
+	virtual void Read(long long *Values) = 0;
+};
+
+/**
+ * 各渲染阶段的计数器的值，下标依次为阶段与计数器
+ */
+using RCProfileCounterValues = std::array<std::array<long long, RCProfileCounters::MaxCounterCount>, RCProfileStageCount>;
+
+/**
+ * 帧分析器，以环形缓冲区保存最近若干帧各渲染阶段的耗时，并据此给出百分位数。
+ * 一帧的各阶段耗时先通过 Record 累加到当前帧，调用 CommitFrame 后才会写入环形缓冲区。
+ * 该分析器不是线程安全的，多线程渲染的阶段应当由渲染器汇总后再记录
+ */
+class RCProfiler {
+public:
+	/**
+	 * 默认保存的帧数
+	 */
+	static constexpr int DefaultCapacity = 256;
+
+public:
+	/**
+	 * 创建一个帧分析器
+	 * @param Capacity 环形缓冲区保存的帧数，必须大于零
+	 */
+	explicit RCProfiler(const int &Capacity = DefaultCapacity);
+
+public:
+	/**
+	 * 将一段耗时累加到当前帧的指定阶段
+	 * @param Stage 渲染阶段
+	 * @param Milliseconds 耗时（毫秒）
+	 */
+	void Record(const RCProfileStage &Stage, const double &Milliseconds);
+	/**
+	 * 将当前帧写入环形缓冲区并开始新的一帧，当前帧没有记录任何阶段时不写入
+	 */
+	void CommitFrame();
+	/**
+	 * 清空环形缓冲区与当前帧
+	 */
+	void Clear();
+	/**
+	 * 重新设置环形缓冲区保存的帧数，已经保存的帧将被清空
+	 * @param Capacity 环形缓冲区保存的帧数，必须大于零
+	 */
+	void SetCapacity(const int &Capacity);
+	/**
+	 * 获取环形缓冲区中已经保存的帧数
+	 * @return 已经保存的帧数
+	 */
+	[[nodiscard]] int GetFrameCount() const;
+	/**
+	 * 获取指定阶段在已经保存的帧中的百分位数（最近秩法）
+	 * @param Stage 渲染阶段
+	 * @param Percentile 百分位，范围为 [0, 100]
+	 * @return 该阶段耗时的百分位数（毫秒），没有保存任何帧时为 0
+	 */
+	[[nodiscard]] double GetPercentile(const RCProfileStage &Stage, const double &Percentile) const;
+	/**
+	 * 获取指定阶段在已经保存的帧中的耗时统计
+	 * @param Stage 渲染阶段
+	 * @return 该阶段的耗时统计，没有保存任何帧时各项均为 0
+	 */
+	[[nodiscard]] RCProfileSummary GetSummary(const RCProfileStage &Stage) const;
+	/**
+	 * 以 CSV 格式输出已经保存的每一帧，每行为一帧，各列为各阶段的耗时（毫秒），由旧到新排列
+	 * @param Stream 输出流
+	 */
+	void WriteFramesCSV(std::ostream &Stream) const;
+	/**
+	 * 以 CSV 格式输出各阶段的耗时统计，每行为一个阶段
+	 * @param Stream 输出流
+	 */
+	void WriteSummaryCSV(std::ostream &Stream) const;
+	/**
+	 * 将 WriteFramesCSV 的结果写入文件
+	 * @param Path 文件路径
+	 */
+	void DumpFramesCSV(const char *Path) const;
+	/**
+	 * 将 WriteSummaryCSV 的结果写入文件
+	 * @param Path 文件路径
+	 */
+	void DumpSummaryCSV(const char *Path) const;
+
+public:
+	/**
+	 * 获取渲染阶段的名称，用于 CSV 的表头
+	 * @param Stage 渲染阶段
+	 * @return 阶段的名称
+	 */
+	static const char *GetStageName(const RCProfileStage &Stage);
+
+private:
+	/**
+	 * 将指定阶段在已经保存的帧中的耗时按由旧到新的顺序复制出来
+	 */
+	std::vector<double> CollectSamples(const RCProfileStage &Stage) const;
+
+private:
+	using Sample = std::array<double, RCProfileStageCount>;
+
+	std::vector<Sample> _samples;
+	/**
+	 * 下一帧写入的位置与已经保存的帧数
+	 */
+	int                 _cursor;
+	int                 _count;
+	/**
+	 * 当前帧各阶段累加的耗时，以及当前帧是否记录过任何阶段
+	 */
+	Sample              _current;
+	bool                _currentRecorded;
+};
+
+/**
+ * 在作用域内计时，离开作用域时将耗时记录到帧分析器的指定阶段，用于 Flush 等在渲染器之外的阶段
+ */
+class RCProfileScope {
+public:
+	RCProfileScope(RCProfiler &Profiler, const RCProfileStage &Stage)
+	    : _profiler(Profiler), _stage(Stage), _start(std::chrono::steady_clock::now()) {
+	}
+	~RCProfileScope() {
+		_profiler.Record(_stage, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - _start).count());
+	}
+
+	RCProfileScope(const RCProfileScope &) = delete;
+	RCProfileScope &operator=(const RCProfileScope &) = delete;
+
+private:
+	RCProfiler                           &_profiler;
+	RCProfileStage                        _stage;
+	std::chrono::steady_clock::time_point _start;
+};
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2023~Now Margoo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/**
+ * \file RCRayPacket.h
+ * \brief 光线包（ray packet）内核，让相邻的若干条光线同时穿过地图中的空气，包含标量、SSE4.1 与 AVX2 实现
+ */
+
+#pragma once
+
+#include <include/RCMap.h>
+#include <include/RCSpanKernel.h>
+
+namespace RCRender {
+	/**
+	 * 一个光线包最多包含的光线数，即 AVX2 寄存器中 32 位整数的个数
+	 */
+	constexpr int MaxRayPacketSize = 8;
+
+	/**
+	 * 从同一起点发出的一组光线，以 SoA 形式存放。调用者填写起点、最大距离与各条光线的方向，
+	 * 内核构造各条光线并让其穿过空气，之后可由 GetRay 取出各条光线继续逐格步进
+	 */
+	struct RayPacket {
+		float positionX;
+		float positionY;
+		// 光线越过该距离（RCMapRay::IsBeyond）后即停止步进，为正无穷时不限制
+		float maxDistance;
+		alignas(32) float directionX[MaxRayPacketSize];
+		alignas(32) float directionY[MaxRayPacketSize];
+
+		// 各条光线的状态，与 RCMapRay 的成员一一对应
+		alignas(32) int   mapX[MaxRayPacketSize];
+		alignas(32) int   mapY[MaxRayPacketSize];
+		alignas(32) int   stepX[MaxRayPacketSize];
+		alignas(32) int   stepY[MaxRayPacketSize];
+		alignas(32) int   countX[MaxRayPacketSize];
+		alignas(32) int   countY[MaxRayPacketSize];
+		alignas(32) float originX[MaxRayPacketSize];
+		alignas(32) float originY[MaxRayPacketSize];
+		alignas(32) float deltaDistanceX[MaxRayPacketSize];
+		alignas(32) float deltaDistanceY[MaxRayPacketSize];
+		alignas(32) float sideDistanceX[MaxRayPacketSize];
+		alignas(32) float sideDistanceY[MaxRayPacketSize];
+
+		// 各条光线最后一次是否沿 X 方向步进（非零为是），以及调用 RCMapRay::Step 的次数
+		alignas(32) int   sideX[MaxRayPacketSize];
+		alignas(32) int   steps[MaxRayPacketSize];
+
+		/**
+		 * 获取第 Lane 条光线
+		 */
+		[[nodiscard]] RCMapRay GetRay(const int &Lane) const {
+			RCMapRay ray;
+			ray.mapX           = mapX[Lane];
+			ray.mapY           = mapY[Lane];
+			ray.stepX          = stepX[Lane];
+			ray.stepY          = stepY[Lane];
+			ray.countX         = countX[Lane];
+			ray.countY         = countY[Lane];
+			ray.originX        = originX[Lane];
+			ray.originY        = originY[Lane];
+			ray.deltaDistanceX = deltaDistanceX[Lane];
+			ray.deltaDistanceY = deltaDistanceY[Lane];
+			ray.sideDistanceX  = sideDistanceX[Lane];
+			ray.sideDistanceY  = sideDistanceY[Lane];
+
+			return ray;
+		}
+		/**
+		 * 写回第 Lane 条光线中会随步进改变的成员
+		 */
+		void SetRay(const int &Lane, const RCMapRay &Ray) {
+			mapX[Lane]          = Ray.mapX;
+			mapY[Lane]          = Ray.mapY;
+			countX[Lane]        = Ray.countX;
+			countY[Lane]        = Ray.countY;
+			sideDistanceX[Lane] = Ray.sideDistanceX;
+			sideDistanceY[Lane] = Ray.sideDistanceY;
+		}
+	};
+
+	/**
+	 * 构造 Packet 中的前 Count 条光线，并让它们分别重复「RCMap::SkipEmptySpace、RCMapRay::Step」直到停在非空气的单位上
+	 * 或越过 Packet.maxDistance，即至少步进一次。各条光线的状态与以 RCMapRay 的构造函数构造后逐条步进的结果逐位相同。
+	 * DistanceField 为地图的距离场，其后至少需要 3 个字节的填充
+	 */
+	using RayPacketKernel = void (*)(const unsigned char *DistanceField, const int &MapWidth, RayPacket &Packet,
+	                                 const int &Count);
+
+	/**
+	 * 获取指定指令集的光线包内核
+	 * @param Set 目标指令集，调用者需确保当前 CPU 支持该指令集
+	 * @return 光线包内核
+	 */
+	RayPacketKernel GetRayPacketKernel(const InstructionSet &Set);
+
+	/**
+	 * 让单条光线步进到非空气的单位上或越过最大距离，是其余实现的参考，亦用于完成光线包中分散的光线
+	 * @param DistanceField 地图的距离场
+	 * @param MapWidth 地图的长
+	 * @param MaxDistance 最大距离
+	 * @param Ray 需要步进的光线
+	 * @param SideX 最后一次是否沿 X 方向步进
+	 * @param Steps 调用 Step 的次数
+	 */
+	inline void TraceRayScalar(const unsigned char *DistanceField, const int &MapWidth, const float &MaxDistance,
+	                           RCMapRay &Ray, bool &SideX, int &Steps) {
+		Steps = 0;
+		int distance = DistanceField[Ray.mapX + Ray.mapY * MapWidth];
+		do {
+			if (distance > 1) {
+				Ray.Skip(distance - 1);
+			}
+			SideX = Ray.Step();
+			++Steps;
+			distance = DistanceField[Ray.mapX + Ray.mapY * MapWidth];
+		} while (distance != 0 && !Ray.IsBeyond(MaxDistance));
+	}
+
+	/**
+	 * 标量实现，逐条构造光线并步进
+	 */
+	void TraceRayPacketScalar(const unsigned char *DistanceField, const int &MapWidth, RayPacket &Packet,
+	                          const int &Count);
+	/**
+	 * SSE4.1 实现，每 4 条光线以掩码同步步进
+	 */
+	void TraceRayPacketSSE41(const unsigned char *DistanceField, const int &MapWidth, RayPacket &Packet,
+	                         const int &Count);
+	/**
+	 * AVX2 实现，8 条光线以掩码同步步进，以 gather 指令读取距离场
+	 */
+	void TraceRayPacketAVX2(const unsigned char *DistanceField, const int &MapWidth, RayPacket &Packet,
+	                        const int &Count);
+}
@@ -79,6 +79,7 @@ public:
 	inline void WritePixel(const int &Position, const COLORREF &Color) {
 		_backBuffer[Position] = Color;
 	}
+#ifdef _RC_BACKEND_EASYX_
 	/**
 	 * 加载当前 RenderTarget 至 EasyX 的工作区中
 	 */
@@ -88,6 +89,7 @@ public:
 	 * @return RenderTarget 的 EasyX 对象
 	 */
 	IMAGE* GetImage();
+#endif
 	/**
 	 * 获取当前 RenderTarget 的 RCContext 对象
 	 * @return RenderTarget 的 RCContext 对象
@@ -97,13 +99,24 @@ public:
 public:
 	/**
 	 * 刷新渲染对象，注意，当渲染对象为窗口时将调用批量绘图接口，
-	 * 而当渲染对象为图像时，该函数将无任何行为
+	 * 而当渲染对象为图像或处于无头后端时，该函数将无任何行为
 	 */
 	void Flush();
 	/**
 	 * 清空渲染对象
 	 */
 	void Clear();
+	/**
+	 * 将源渲染对象左上角 SourceWidth x SourceHeight 的区域拉伸（最近邻）至本渲染对象
+	 * 左上角 Width x Height 的区域，等价于 GDI 的 StretchBlt
+	 * @param Source 源渲染对象
+	 * @param Width 目标区域的宽
+	 * @param Height 目标区域的高
+	 * @param SourceWidth 源区域的宽
+	 * @param SourceHeight 源区域的高
+	 */
+	void StretchBlit(RCRenderTarget *Source, const int &Width, const int &Height,
+	                 const int &SourceWidth, const int &SourceHeight);
 
 private:
 	friend class RCRenderer;
@@ -30,16 +30,28 @@
 #include <include/RCRenderTarget.h>
 #include <include/RCCamera.h>
 #include <include/RCScene.h>
+#include <include/RCThreadPool.h>
+#include <include/RCRayPacket.h>
+#include <include/RCColumnKernel.h>
+#include <include/RCSpanKernel.h>
+#include <include/RCUpscale.h>
+#include <include/RCFrameArena.h>
+#include <include/RCProfiler.h>
 
+#include <array>
 #include <numbers>
-#include <thirdparty/MemoryPool/C-11/MemoryPool.h>
 
 namespace RCRender {
 	/**
   	  * Render 内部使用的精灵对象
   	  */
 	struct Sprite {
-		RCTexture *texture;
+		// 依据距离选择的 mipmap 层级的纹理
+		const DWORD *textureBuffer;
+		// 按列存储的纹理，未生成时为 nullptr
+		const DWORD *textureColumnBuffer;
+		int textureWidth;
+		int textureHeight;
 		int drawStartX;
 		int drawStartY;
 		int drawEndX;
@@ -51,7 +63,11 @@ namespace RCRender {
 		int textureX;
 		int textureY;
 		float transformY;
-		float fog;
+		TextureStepper stepperY;
+		// 精灵所在距离的烟雾颜色表，为 nullptr 时无烟雾
+		const BYTE *colormap;
+		// 精灵在场景精灵列表中的下标
+		int index;
 	};
 	enum class HideSide {
 		NS,
@@ -70,6 +86,138 @@ namespace RCRender {
 		RCMapUnit unit;
 		HideSide hitSide;
 	};
+	/**
+	 * 定点数遍历时某一列光线的方向与沿 X、Y 方向前进一格所需的距离，均为 16.16 定点数
+	 */
+	struct FixedColumn {
+		int       directionX;
+		int       directionY;
+		long long deltaDistanceX;
+		long long deltaDistanceY;
+	};
+	/**
+	 * 以整数运算求出定点数遍历时指定列的光线，结果只取决于量化后的相机方向与平面向量
+	 * @param DirectionX 相机方向的 X 分量（定点数）
+	 * @param DirectionY 相机方向的 Y 分量（定点数）
+	 * @param PlaneX 相机平面向量的 X 分量（定点数）
+	 * @param PlaneY 相机平面向量的 Y 分量（定点数）
+	 * @param Column 列的下标
+	 * @param Width 画面的宽度
+	 * @return 该列的光线
+	 */
+	inline FixedColumn MakeFixedColumn(const int &DirectionX, const int &DirectionY, const int &PlaneX,
+	                                   const int &PlaneY, const int &Column, const int &Width) {
+		// cameraX = (2 * Column - Width) / Width
+		const long long offset = 2LL * Column - Width;
+
+		FixedColumn column{};
+		column.directionX     = DirectionX + static_cast<int>(PlaneX * offset / Width);
+		column.directionY     = DirectionY + static_cast<int>(PlaneY * offset / Width);
+		column.deltaDistanceX = RCMapFixedRay::GetDeltaDistance(column.directionX);
+		column.deltaDistanceY = RCMapFixedRay::GetDeltaDistance(column.directionY);
+
+		return column;
+	}
+	/**
+	 * 一帧画面的更新方式
+	 */
+	enum class FrameUpdate {
+		// 重新渲染整帧
+		Full,
+		// 只重新渲染状态改变的门与精灵所在的列
+		Partial,
+		// 相机与场景均未改变，沿用上一帧的画面
+		Reused
+	};
+	/**
+	 * 画布上连续的列 [start, end)
+	 */
+	struct ColumnRange {
+		int start;
+		int end;
+	};
+	/**
+	 * 渲染一帧时相机的状态
+	 */
+	struct CameraState {
+		float positionX;
+		float positionY;
+		float directionX;
+		float directionY;
+		float planeX;
+		float planeY;
+		float z;
+		float pitch;
+
+		bool operator==(const CameraState &) const = default;
+	};
+	/**
+	 * 渲染一帧时门的状态
+	 */
+	struct DoorState {
+		// 门所在单位的下标
+		int              position;
+		const RCMapDoor *door;
+		float            offset;
+		int              max;
+
+		bool operator==(const DoorState &) const = default;
+	};
+	/**
+	 * 渲染一帧时精灵的状态
+	 */
+	struct SpriteState {
+		const RCSprite  *sprite;
+		const RCTexture *texture;
+		float            x;
+		float            y;
+		float            z;
+
+		bool operator==(const SpriteState &) const = default;
+	};
+	/**
+	 * 渲染器的统计信息
+	 */
+	struct Statistics {
+		// 上一帧渲染墙体与精灵所用的时间（毫秒）
+		double wallPassTime;
+		// 场景中墙体与精灵的纹理按列存储的副本占用的内存（字节）
+		size_t columnMajorTextureSize;
+		// 上一帧从开始渲染到放大完成所用的时间（毫秒）
+		double frameTime;
+		// 当前的渲染缩放比例，内部分辨率为渲染目标的宽高乘以该比例
+		float  renderScale;
+		// 上一帧的更新方式，以及重新渲染的列数（内部分辨率下）
+		FrameUpdate frameUpdate;
+		int         updatedColumns;
+		// 上一帧求交的光线数与 DDA 的总步数（不包括借助距离场跳过的格子）
+		int         tracedRays;
+		long long   traceSteps;
+	};
+	/**
+	 * 每个渲染线程独占的临时内存，避免线程之间争用分配器，每帧开始时重置
+	 */
+	struct ThreadContext {
+		RCFrameArena frameArena;
+		/**
+		 * 本线程负责的各列的击中物体，每一列在其中的位置由 RCRenderer 记录
+		 */
+		MapObject   *hitList     = nullptr;
+		size_t       hitCount    = 0;
+		size_t       hitCapacity = 0;
+		/**
+		 * 本线程在本帧各渲染阶段所用的时间（毫秒）
+		 */
+		std::array<double, RCProfileStageCount> stageTime{};
+		/**
+		 * 本线程在本帧各渲染阶段中计数器的增量，仅在设置了计数器来源时统计
+		 */
+		RCProfileCounterValues stageCounters{};
+		/**
+		 * 本线程在本帧求交时 DDA 的总步数
+		 */
+		long long    traceSteps  = 0;
+	};
 }
 
 /**
@@ -83,6 +231,7 @@ public:
 	 * @param Camera 渲染器的相机指针
 	 */
 	RCRenderer(RCRenderTarget *RenderTarget, RCCamera *Camera, RCScene *Scene);
+	~RCRenderer();
 
 public:
 	/**
@@ -100,18 +249,110 @@ public:
 public:
 	/**
 	 * 启用超分渲染（插值超分），在高分辨率下建议启用超分渲染。
-	 * 默认启用 2x 超分
+	 * 启用时等价于 SetRenderScale(0.5f)，禁用时等价于 SetRenderScale(1.f)
 	 * @param Status 当为 true 时，则启用超分渲染，否则禁用超分渲染
 	 */
 	void EnableSuperResolution(const bool &Status);
+	/**
+	 * 设置渲染缩放比例，渲染器将以渲染目标的宽高乘以该比例的内部分辨率渲染，
+	 * 再由放大内核放大到渲染目标上。比例为 1 时直接渲染到渲染目标上，默认为 1
+	 * @param Scale 渲染缩放比例，范围为 (0, 1]
+	 */
+	void SetRenderScale(const float &Scale);
+	/**
+	 * 获取当前的渲染缩放比例，启用动态分辨率时该值会随帧时间变化
+	 * @return 当前的渲染缩放比例
+	 */
+	[[nodiscard]] float GetRenderScale() const;
+	/**
+	 * 设置目标帧时间，启用动态分辨率。渲染器会统计最近若干帧的帧时间，
+	 * 超出目标时降低渲染缩放比例，预计提高一级后仍不超出目标时再提高一级
+	 * @param Milliseconds 目标帧时间（毫秒），为 0 时禁用动态分辨率并保持当前的渲染缩放比例
+	 */
+	void SetTargetFrameTime(const double &Milliseconds);
+	/**
+	 * 设置动态分辨率的调整范围，渲染缩放比例只会取 MinimumScale + k * Step 或 MaximumScale。
+	 * 默认范围为 [0.5, 1]，步长为 0.125
+	 * @param MinimumScale 最小的渲染缩放比例
+	 * @param MaximumScale 最大的渲染缩放比例
+	 * @param Step 每一级的步长
+	 */
+	void SetDynamicResolutionRange(const float &MinimumScale, const float &MaximumScale, const float &Step);
+	/**
+	 * 设置将内部分辨率的画面放大到渲染目标时使用的插值方式，默认为最近邻插值
+	 * @param Filter 插值方式
+	 */
+	void SetUpscaleFilter(const RCRender::UpscaleFilter &Filter);
+	/**
+	 * 启用遮挡剔除，启用后渲染器会先求出每一列被不透明墙体覆盖的行，
+	 * 地板、天花板与天空盒只渲染墙体之外的部分，以减少被墙体覆盖而浪费的像素。
+	 * 渲染结果与禁用时完全一致，默认禁用
+	 * @param Status 当为 true 时，则启用遮挡剔除，否则禁用遮挡剔除
+	 */
+	void EnableOverdrawCulling(const bool &Status);
+	/**
+	 * 启用 mipmap，启用后墙体、精灵、地板与天花板将依据距离选择纹理的 mipmap 层级，
+	 * 远处的物体读取更小的层级，以减少缓存缺失与摩尔纹，但远处的纹理会比禁用时模糊。默认禁用
+	 * @param Status 当为 true 时，则启用 mipmap，否则始终使用原始纹理
+	 */
+	void EnableMipmap(const bool &Status);
+	/**
+	 * 启用光线包，启用后相邻的若干列的光线将以 SIMD 指令同步穿过空气，直到各自击中第一个非空气单位，
+	 * 此后仍逐列求交。求交结果与禁用时完全一致，CPU 不支持 SSE4.1 时无效，默认启用
+	 * @param Status 当为 true 时，则启用光线包，否则逐列步进
+	 */
+	void EnableRayPackets(const bool &Status);
+	/**
+	 * 启用画面复用，启用后渲染器会与上一帧比较相机、场景设置、地图、门与精灵的状态：
+	 * 均未改变时不写入画布，直接沿用上一帧；只有门或精灵改变时，只重新渲染受其影响的列。
+	 * 启用后调用者不能在两帧之间改写画布，修改纹理的内容后需要调用 InvalidateFrame。默认禁用
+	 * @param Status 当为 true 时，则启用画面复用，否则每一帧都重新渲染整帧
+	 */
+	void EnableFrameReuse(const bool &Status);
+	/**
+	 * 使上一帧的画面失效，下一帧将重新渲染整帧
+	 */
+	void InvalidateFrame();
+	/**
+	 * 设置渲染使用的线程数，墙体、精灵与天空盒将按列分块，地板与天花板将按行分块，
+	 * 分别交由不同的线程渲染。默认为 1，即在调用 Render 的线程上完成全部渲染
+	 * @param Count 线程数，必须大于零
+	 */
+	void SetThreadCount(const int &Count);
+	/**
+	 * 获取渲染使用的线程数
+	 * @return 渲染使用的线程数
+	 */
+	[[nodiscard]] int GetThreadCount() const;
 
 public:
 	/**
-	 * 在目标渲染器上渲染一帧，该函数会清空目标渲染器再进行渲染，
+	 * 在目标渲染器上渲染一帧，该函数会覆盖目标渲染器上的所有像素，
 	 * 并在渲染结束后不会进行 flush
 	 * @return 返回值为当前的理论帧率，用于交互器处理用户输入
 	 */
 	float Render();
+	/**
+	 * 获取渲染器的统计信息，其中的内存占用在调用时统计
+	 * @return 渲染器的统计信息
+	 */
+	[[nodiscard]] RCRender::Statistics GetStatistics() const;
+	/**
+	 * 获取渲染器的帧分析器，每次调用 Render 时会先提交上一帧的样本，因此调用者在 Render 之后
+	 * 计时的阶段（如 Flush）会计入同一帧。多线程渲染的阶段取各线程中耗时最长者
+	 * @return 渲染器的帧分析器
+	 */
+	[[nodiscard]] RCProfiler &GetProfiler();
+	/**
+	 * 设置渲染阶段的计数器来源，渲染器不会接管其所有权。读取计数器需要额外的开销，默认为 nullptr，即不统计
+	 * @param Counters 计数器来源，为 nullptr 时不统计
+	 */
+	void SetProfileCounters(RCProfileCounters *Counters);
+	/**
+	 * 获取上一帧各渲染阶段中计数器的增量，多线程渲染的阶段为各线程之和
+	 * @return 各渲染阶段的计数器的增量
+	 */
+	[[nodiscard]] const RCProfileCounterValues &GetStageCounters() const;
 
 private:
 	/**
@@ -119,58 +360,172 @@ private:
 	 * @param Width 窗口宽度
 	 * @param Height 窗口高度
 	 * @param Pitch 计算后的 Pitch 常量
-	 * @param FogConstant 烟雾的常量
 	 * @param RayRightDirection 右平面向量
 	 * @param RayLeftDirection 左平面向量
 	 * @param CameraZ 相机的虚拟 Z 坐标
+	 * @param Start 渲染的起始行
+	 * @param End 渲染的结束行（不包括）
+	 * @param ColumnStart 渲染的起始列
+	 * @param ColumnEnd 渲染的结束列（不包括）
 	 */
 	void RenderFloor(const int &Width, const int &Height, const float &Pitch,
-	                 const int& FogConstant, const vecmath::Vector<float>& RayRightDirection,
+	                 const vecmath::Vector<float>& RayRightDirection,
 	                 const vecmath::Vector<float>& RayLeftDirection, const float& CameraZ,
-	                 const int &Start);
+	                 const int &Start, const int &End, const int &ColumnStart, const int &ColumnEnd);
 	/**
 	 * 渲染天花板
 	 * @param Width 窗口宽度
 	 * @param Height 窗口高度
 	 * @param Pitch 计算后的 Pitch 常量
-	 * @param FogConstant 烟雾的常量
 	 * @param RayRightDirection 右平面向量
 	 * @param RayLeftDirection 左平面向量
 	 * @param CameraZ 相机的虚拟 Z 坐标
+	 * @param Start 渲染的起始行
+	 * @param End 渲染的结束行（不包括）
+	 * @param ColumnStart 渲染的起始列
+	 * @param ColumnEnd 渲染的结束列（不包括）
 	 */
 	void RenderCeiling(const int &Width, const int &Height, const float &Pitch,
-	                   const int& FogConstant, const vecmath::Vector<float>& RayRightDirection,
+	                   const vecmath::Vector<float>& RayRightDirection,
 	                   const vecmath::Vector<float>& RayLeftDirection, const float& CameraZ,
-	                   const int &Start);
+	                   const int &Start, const int &End, const int &ColumnStart, const int &ColumnEnd);
+	/**
+	 * 依据地板或天花板一行中每个像素在世界坐标中跨越的长度，为该行选择纹理的 mipmap 层级
+	 * @param Texture 地板或天花板的纹理
+	 * @param Footprint 每个像素在世界坐标中跨越的长度，一格对应整张纹理
+	 * @param Span 将被写入所选层级的纹理与大小的行
+	 */
+	void SelectFloorMipLevel(RCTexture *Texture, const float &Footprint, RCRender::FloorSpan &Span) const;
+	/**
+	 * 使用行扫描内核渲染地板或天花板的一行，启用遮挡剔除时只渲染未被墙体覆盖的区间
+	 * @param Kernel 该行的特性对应的行扫描内核
+	 * @param Span 已经填写好纹理、坐标与烟雾信息的行
+	 * @param Y 行的下标
+	 * @param Start 渲染的起始列
+	 * @param End 渲染的结束列（不包括）
+	 */
+	void RenderFloorSpans(const RCRender::FloorSpanKernel &Kernel, RCRender::FloorSpan &Span, const int &Y,
+	                      const int &Start, const int &End);
 	/**
 	 * 渲染天空盒
 	 * @param Width 窗口宽度
 	 * @param Height 窗口高度
 	 * @param Pitch 计算后的 Pitch 常量
-	 * @param FogConstant 烟雾的常量
 	 * @param RayRightDirection 右平面向量
 	 * @param RayLeftDirection 左平面向量
+	 * @param Start 渲染的起始列
+	 * @param End 渲染的结束列（不包括）
 	 */
 	void RenderSkyBox(const int &Width, const int &Height, const float &Pitch,
-	                  const int& FogConstant, const vecmath::Vector<float>& RayRightDirection,
+	                  const vecmath::Vector<float>& RayRightDirection,
 	                  const vecmath::Vector<float>& RayLeftDirection,
-	                  const int &Start);
+	                  const int &Start, const int &End);
 	/**
-	 * 渲染墙体、玻璃、门、暗门等物体
+	 * 对每一列进行光线投射，记录击中的物体、最近的不透明墙体的距离与其覆盖的行，不会写入画布
+	 * @param Width 窗口宽度
+	 * @param Height 窗口高度
+	 * @param Pitch 计算后的 Pitch 常量
+	 * @param Start 投射的起始列
+	 * @param End 投射的结束列（不包括）
+	 * @param Context 当前线程的临时内存，击中的物体将存放在其中
+	 */
+	void TraceColumns(const int &Width, const int &Height, const float &Pitch, const int &Start, const int &End,
+	                  RCRender::ThreadContext &Context);
+	/**
+	 * 与 TraceColumns 相同，但以 16.16 定点数（RCMapFixedRay）逐列步进，不使用光线包，
+	 * 各列的方向与步进距离取自 UpdateFixedColumns 建立的表
+	 * @param Width 窗口宽度
+	 * @param Height 窗口高度
+	 * @param Pitch 计算后的 Pitch 常量
+	 * @param Start 投射的起始列
+	 * @param End 投射的结束列（不包括）
+	 * @param Context 当前线程的临时内存，击中的物体将存放在其中
+	 */
+	void TraceColumnsFixed(const int &Width, const int &Height, const float &Pitch, const int &Start, const int &End,
+	                       RCRender::ThreadContext &Context);
+	/**
+	 * 依据量化后的相机方向与平面向量重建每一列的定点数光线表，相机未转动且画面宽度不变时沿用上一帧的表
+	 */
+	void UpdateFixedColumns();
+	/**
+	 * 计算一面墙体在画面上未经裁剪的起始行与结束行（包括）
+	 * @param PerpDistance 墙体到相机平面的垂直距离
+	 * @param Pitch 计算后的 Pitch 常量
+	 * @param DrawStart 起始行
+	 * @param DrawEnd 结束行
+	 */
+	void GetWallRows(const float &PerpDistance, const float &Pitch, int &DrawStart, int &DrawEnd) const;
+	/**
+	 * 将一个击中的物体追加到当前线程的列表中，若该物体为不透明的墙体或关闭的门，
+	 * 则记录该列的深度与墙体覆盖的行
+	 * @param Object 击中的物体
+	 * @param X 物体所在的列
+	 * @param Height 窗口高度
+	 * @param Pitch 计算后的 Pitch 常量
+	 * @param Context 当前线程的临时内存
+	 * @return 若光线被该物体完全遮挡则返回 true，否则返回 false
+	 */
+	bool RecordHit(const RCRender::MapObject &Object, const int &X, const int &Height, const float &Pitch,
+	               RCRender::ThreadContext &Context);
+	/**
+	 * 依据 TraceColumns 的结果渲染墙体、玻璃、门、暗门等物体
 	 * @param Width 窗口宽度
 	 * @param Height 窗口高度
 	 * @param Pitch 计算后的 Pitch 常量
-	 * @param FogConstant 烟雾的常量
 	 * @param RayRightDirection 右平面向量
 	 * @param RayLeftDirection 左平面向量
+	 * @param Start 渲染的起始列
+	 * @param End 渲染的结束列（不包括）
+	 * @param Context 当前渲染线程的临时内存，必须与 TraceColumns 时使用的一致
 	 */
 	void RayCasting(const int &Width, const int &Height, const float &Pitch,
-	                const int& FogConstant, const vecmath::Vector<float>& RayRightDirection,
-	                const vecmath::Vector<float>& RayLeftDirection, const int &Start);
+	                const vecmath::Vector<float>& RayRightDirection,
+	                const vecmath::Vector<float>& RayLeftDirection, const int &Start, const int &End,
+	                RCRender::ThreadContext &Context);
+	/**
+	 * 投影、剔除并按距离排序场景中的精灵，同时建立每一列的精灵索引，每帧只需执行一次
+	 * @param Pitch 计算后的 Pitch 常量
+	 */
+	void PrepareSprites(const float &Pitch);
+	/**
+	 * 渲染精灵的一列
+	 * @param sprite 渲染的精灵
+	 * @param x 列的下标
+	 * @param Column 该列的第一个像素，相邻两个像素相隔一行
+	 */
+	void RenderSprite(const RCRender::Sprite& sprite, const int &x, DWORD *Column);
+	/**
+	 * 渲染一帧画面，需要重新渲染的列由 _frameUpdate 决定
+	 */
+	void RenderFrame();
 	/**
-	 * 渲染精灵
+	 * 与上一帧比较相机、场景设置与地图的版本、门与精灵的状态，并记录本帧的状态。
+	 * 只有门或精灵改变时，改变的门所在的单位与精灵的下标分别记录在 _changedDoors 与 _changedSprites 中
+	 * @return 本帧的更新方式
 	 */
-	void RenderSprite(RCRender::Sprite& sprite, const int &x, const float& fog);
+	RCRender::FrameUpdate CheckFrameUpdate();
+	/**
+	 * 依据求交的结果与精灵在上一帧和本帧覆盖的列，求出需要重新渲染的列并存放在 _columnRanges 中
+	 */
+	void CollectDirtyColumns();
+	/**
+	 * 记录本帧各精灵覆盖的列
+	 */
+	void RecordSpriteColumns();
+	/**
+	 * 应用渲染缩放比例，按需调整内部分辨率画布的大小
+	 * @param Scale 渲染缩放比例
+	 */
+	void ApplyRenderScale(const float &Scale);
+	/**
+	 * 记录一帧的帧时间，并依据最近若干帧的平均帧时间调整渲染缩放比例
+	 * @param FrameTime 该帧的帧时间（毫秒）
+	 */
+	void UpdateDynamicResolution(const double &FrameTime);
+	/**
+	 * 将各线程在本帧各渲染阶段所用的时间记录到帧分析器中，并汇总各线程的计数器与求交的步数
+	 */
+	void RecordThreadStages();
 
 
 #ifdef _RC_RENDER_DEBUGER_
@@ -192,24 +547,143 @@ private:
 
 private:
 	/**
-	 * 是否启用超分渲染，当启用超分渲染。渲染器会渲染一个比指定大小小 4 倍的图片并通过
-	 * 直接放大来近似原结果
+	 * 是否以内部分辨率渲染，渲染缩放比例小于 1 时，渲染器会渲染一个较小的图片并通过
+	 * 放大内核放大来近似原结果
 	 */
 	bool             _enableResolution;
 	RCContext       *_contextResolution;
 	RCRenderTarget  *_resolutionRenderTarget;
-	HDC              _resolutionDC;
-	HDC              _renderTargetDC;
 	int              _resolutionWidth;
 	int              _resolutionHeight;
-	float            _fogColorR;
-	float            _fogColorG;
-	float            _fogColorB;
 	int              _renderTargetWidth;
 	int              _renderTargetHeight;
 	RCScene         *_scene;
 	RCCamera        *_camera;
 	RCRenderTarget  *_renderTarget;
-	MemoryPool<RCRender::MapObject> _mapObjectMemoryPool;
-	MemoryPool<RCRender::Sprite> _spriteMemoryPool;
+	RCThreadPool    *_threadPool;
+
+	/**
+	 * 地板与天花板的行扫描内核，依据 CPU 支持的指令集选择，下标为 RCRender::FloorFeature 的组合
+	 */
+	std::array<RCRender::FloorSpanKernel, RCRender::FloorFeature::Count> _floorSpanKernels;
+	/**
+	 * 墙体求交时的光线包内核，依据 CPU 支持的指令集选择，禁用光线包时为标量实现
+	 */
+	RCRender::RayPacketKernel     _rayPacketKernel;
+	/**
+	 * 定点数遍历时每一列的光线，以及建立该表时量化后的相机方向与平面向量
+	 */
+	std::vector<RCRender::FixedColumn> _fixedColumns;
+	std::array<int, 4>                 _fixedColumnCamera;
+
+	/**
+	 * 各线程共享的本帧临时数据（精灵列表与每列的索引）的分配器，每帧开始时重置
+	 */
+	RCFrameArena                  _frameArena;
+	/**
+	 * 本帧可见的精灵，按距离由近到远排序
+	 */
+	RCRender::Sprite             *_spriteList;
+	int                           _spriteCount;
+	/**
+	 * 每一列的精灵索引，第 x 列的精灵下标为
+	 * _spriteColumnIndex[_spriteColumnOffset[x], _spriteColumnOffset[x + 1])
+	 */
+	int                          *_spriteColumnOffset;
+	int                          *_spriteColumnIndex;
+	/**
+	 * 每一列最近的不透明墙体的距离，远于该距离的精灵将被遮挡
+	 */
+	float                        *_columnDepth;
+	/**
+	 * 每一列击中的物体在对应线程击中列表中的位置与个数
+	 */
+	int                          *_columnHitOffset;
+	int                          *_columnHitCount;
+	/**
+	 * 每一列被不透明墙体覆盖的行 [_columnCoverStart[x], _columnCoverEnd[x]]，为空时起始大于结束
+	 */
+	int                          *_columnCoverStart;
+	int                          *_columnCoverEnd;
+	/**
+	 * 是否启用遮挡剔除
+	 */
+	bool                          _enableOverdrawCulling;
+	/**
+	 * 是否启用 mipmap
+	 */
+	bool                          _enableMipmap;
+	/**
+	 * 上一帧渲染墙体与精灵所用的时间（毫秒）
+	 */
+	double                        _wallPassTime;
+	/**
+	 * 当前的渲染缩放比例与动态分辨率的调整范围
+	 */
+	float                         _renderScale;
+	float                         _minimumRenderScale;
+	float                         _maximumRenderScale;
+	float                         _renderScaleStep;
+	/**
+	 * 目标帧时间（毫秒），为 0 时禁用动态分辨率
+	 */
+	double                        _targetFrameTime;
+	/**
+	 * 上一帧从开始渲染到放大完成所用的时间（毫秒）
+	 */
+	double                        _frameTime;
+	/**
+	 * 最近若干帧的帧时间（环形缓冲区）与其中有效的帧数，渲染缩放比例改变后清空，
+	 * 以免以旧分辨率的帧时间再次调整
+	 */
+	std::array<double, 8>         _frameTimeHistory;
+	int                           _frameTimeCursor;
+	int                           _frameTimeCount;
+	/**
+	 * 内部分辨率的画面放大到渲染目标时使用的放大内核，依据插值方式与 CPU 支持的指令集选择
+	 */
+	RCRender::UpscaleKernel       _upscaleKernel;
+
+	/**
+	 * 是否启用画面复用，以及画布上是否保留着可以沿用的上一帧
+	 */
+	bool                          _enableFrameReuse;
+	bool                          _frameValid;
+	/**
+	 * 本帧的更新方式与需要重新渲染的列，整帧渲染时为 [0, 宽度)
+	 */
+	RCRender::FrameUpdate         _frameUpdate;
+	std::vector<RCRender::ColumnRange> _columnRanges;
+	int                           _updatedColumns;
+	/**
+	 * 本帧求交的光线数与 DDA 的总步数
+	 */
+	int                           _tracedRays;
+	long long                     _traceSteps;
+	/**
+	 * 上一帧的相机、场景、门与精灵的状态，以及各精灵覆盖的列
+	 */
+	RCRender::CameraState         _frameCamera;
+	const RCScene                *_frameScene;
+	unsigned int                  _frameSceneVersion;
+	unsigned int                  _frameMapVersion;
+	std::vector<RCRender::DoorState>   _frameDoors;
+	std::vector<RCRender::SpriteState> _frameSprites;
+	std::vector<RCRender::ColumnRange> _frameSpriteColumns;
+	/**
+	 * 本帧状态改变的门所在的单位与精灵的下标
+	 */
+	std::vector<int>              _changedDoors;
+	std::vector<int>              _changedSprites;
+	/**
+	 * 按渲染阶段统计耗时的帧分析器
+	 */
+	RCProfiler                    _profiler;
+	/**
+	 * 渲染阶段的计数器来源，以及上一帧各阶段中计数器的增量
+	 */
+	RCProfileCounters            *_profileCounters;
+	RCProfileCounterValues        _stageCounters;
+
+	std::vector<RCRender::ThreadContext*> _threadContexts;
 };
\ No newline at end of file
@@ -30,6 +30,8 @@
 #include <include/RCSprite.h>
 #include <include/RCMap.h>
 
+#include <vector>
+
 /**
  * 场景类包含一些有关场景的设置，如天空盒，雾效果
  */
@@ -72,6 +74,24 @@ public:
 	 * @param Count 贴图重复数
 	 */
 	void SetSkyboxRepeat(const unsigned short &Count);
+	/**
+	 * 设置烟雾颜色表的等级数，渲染时烟雾浓度将被量化为这些等级之一。
+	 * 等级越多烟雾的过渡越平滑，但颜色表占用的内存也越大，默认为 64
+	 * @param Levels 颜色表的等级数，取值范围为 [2, 256]
+	 */
+	void SetFogColormapLevels(const int &Levels);
+	/**
+	 * 获取烟雾颜色表的等级数
+	 * @return 烟雾颜色表的等级数
+	 */
+	[[nodiscard]] int GetFogColormapLevels() const;
+	/**
+	 * 获取最大可见距离，启用烟雾剔除后，与相机的距离不小于该值的墙体与精灵将不再渲染，
+	 * 光线也将在此停止步进
+	 * @return 烟雾浓度达到 1 时的距离（地图平均边长 / 烟雾等级），
+	 * 若未启用烟雾或烟雾剔除，或启用了天空盒，则返回正无穷
+	 */
+	[[nodiscard]] float GetMaxVisibleDistance() const;
 
 public:
 	/**
@@ -84,6 +104,24 @@ public:
 	 * @param Status 若为 true 则烟雾效果，若为 false 则禁用烟雾效果
 	 */
 	 void EnableFog(const bool &Status);
+	/**
+	 * 启用定点数光线遍历，启用后渲染器与交互器将以 16.16 定点数（RCMapFixedRay）在地图上步进，
+	 * 遍历的结果只取决于相机量化后的位置与方向，在不同的编译器与指令集下逐位相同，
+	 * 但与浮点数遍历的结果存在细微差异。默认禁用
+	 * @param Status 若为 true 则使用定点数遍历，若为 false 则使用浮点数遍历
+	 */
+	void EnableFixedPointTraversal(const bool &Status);
+	/**
+	 * 启用烟雾剔除，烟雾浓度达到 1 之后的物体均被烟雾完全覆盖，光线到达该距离后即停止步进，
+	 * 更远的精灵也不再投影。默认禁用
+	 *
+	 * 注意：烟雾剔除不保证画面不变。被剔除的墙体原本会被绘制为饱和的烟雾颜色，剔除后这些像素
+	 * 将由加雾的地板与天花板填充，二者的亮度不同，远处墙体的轮廓会随之消失。
+	 * 此外，仅在启用烟雾且禁用天空盒时生效，启用天空盒时该设置被忽略，
+	 * 此时 GetMaxVisibleDistance 返回正无穷，渲染结果与禁用烟雾剔除时相同
+	 * @param Status 若为 true 则启用烟雾剔除，若为 false 则禁用烟雾剔除
+	 */
+	void EnableFogCulling(const bool &Status);
 
 public:
 	/**
@@ -105,13 +143,67 @@ private:
 	friend class RCInteractor;
 
 private:
+	/**
+	 * 获取与相机距离为 Distance 处的烟雾颜色表，颜色表依次为 R、G、B 三个通道各 256 项，
+	 * 第 v 项为通道值 v 与烟雾颜色混合后的结果
+	 * @param Distance 与相机的距离
+	 * @return 对应等级的颜色表，若该处没有烟雾则返回 nullptr
+	 */
+	[[nodiscard]] const BYTE *GetFogColormap(const float &Distance) const {
+		const float level = Distance * _fogDistanceScale;
+		if (!(level > 0)) {
+			return nullptr;
+		}
+		const int index = level >= static_cast<float>(_fogColormapLevels - 1)
+		                  ? _fogColormapLevels - 1 : static_cast<int>(level + 0.5f);
+
+		return _fogColormap.data() + index * 768;
+	}
+	/**
+	 * 获取完全被烟雾覆盖处的颜色表
+	 * @return 最高等级的颜色表
+	 */
+	[[nodiscard]] const BYTE *GetSaturatedFogColormap() const {
+		return _fogColormap.data() + (_fogColormapLevels - 1) * 768;
+	}
+	/**
+	 * 依据烟雾颜色与等级数重建颜色表
+	 */
+	void RebuildFogColormap();
+	/**
+	 * 依据烟雾等级与地图大小更新距离到颜色表等级的比例
+	 */
+	void UpdateFogDistanceScale();
+	/**
+	 * 获取烟雾的常量，即地图的平均边长，距离为 常量 / 烟雾等级 时烟雾浓度为 1
+	 * @return 地图的平均边长
+	 */
+	[[nodiscard]] int GetFogConstant() const {
+		return (_map->GetWidth() + _map->GetHeight()) / 2;
+	}
+
+private:
+	/**
+	 * 烟雾颜色表，每个等级 768 项，末尾额外保留 4 字节以便 SIMD 内核按 32 位读取
+	 */
+	std::vector<BYTE> _fogColormap;
+	int               _fogColormapLevels;
+	float             _fogDistanceScale;
+
 	float        _fogLevel;
 	int          _skyboxRepeats;
 	bool         _enableSkybox;
 	bool         _enableFog;
+	bool         _enableFixedPointTraversal;
+	bool         _enableFogCulling;
 	COLORREF     _fogColor;
 	RCTexture   *_skyBoxTexture;
 	RCTexture   *_floorTexture;
 	RCTexture   *_ceilingTexture;
 	RCMap       *_map;
+
+	/**
+	 * 场景设置的版本号，每次调用设置函数时加一，渲染器借此判断是否可以沿用上一帧
+	 */
+	unsigned int _version;
 };
\ No newline at end of file
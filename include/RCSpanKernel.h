@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2023~Now Margoo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * \file RCSpanKernel.h
+ * \brief 地板与天花板的行扫描（span）内核，包含标量、SSE4.1 与 AVX2 实现
+ */
+
+#pragma once
+
+#include <include/RCBackend.h>
+
+namespace RCRender {
+	/**
+	 * 内核使用的指令集
+	 */
+	enum class InstructionSet {
+		Scalar,
+		SSE41,
+		AVX2
+	};
+	/**
+	 * 地板或天花板的一段像素，第 x 个像素对应的世界坐标为
+	 * (positionX + x * stepX, positionY + x * stepY)，内核渲染 [begin, end) 范围内的像素
+	 */
+	struct FloorSpan {
+		const DWORD *texture;
+		int          textureWidth;
+		int          textureHeight;
+		float        positionX;
+		float        positionY;
+		float        stepX;
+		float        stepY;
+		// 烟雾颜色表，依次为 R、G、B 三个通道各 256 项，仅在启用 FloorFeature::Fog 时读取
+		const BYTE  *colormap;
+		// 为 true 时该行完全被烟雾覆盖，直接以 fogColor 填充，此时不会读取纹理
+		bool         saturated;
+		COLORREF     fogColor;
+		DWORD       *output;
+		int          begin;
+		int          end;
+	};
+	using FloorSpanKernel = void (*)(const FloorSpan &Span);
+	/**
+	 * 行扫描内核的特性位，组合后的特性即为各指令集的内核表的下标
+	 */
+	namespace FloorFeature {
+		// 天花板，纹理坐标由小数部分取负得到
+		constexpr unsigned Ceiling = 1;
+		// 通过烟雾颜色表处理颜色，此时 FloorSpan::colormap 不能为 nullptr
+		constexpr unsigned Fog     = 2;
+		// 特性组合的数量
+		constexpr unsigned Count   = 4;
+	}
+
+	/**
+	 * 通过 CPUID 检测当前 CPU 支持的最高指令集，结果只会计算一次
+	 * @return 当前 CPU 支持的最高指令集
+	 */
+	InstructionSet DetectInstructionSet();
+	/**
+	 * 获取指定指令集与特性组合的行扫描内核
+	 * @param Set 目标指令集，调用者需确保当前 CPU 支持该指令集
+	 * @param Features FloorFeature 的组合，必须小于 FloorFeature::Count
+	 * @return 行扫描内核
+	 */
+	FloorSpanKernel GetFloorSpanKernel(const InstructionSet &Set, const unsigned &Features);
+
+	/**
+	 * 标量实现，亦是其余实现的参考，各特性组合的实例在 RCSpanKernel.cpp 中显式实例化
+	 */
+	template <unsigned Features>
+	void RenderFloorSpanScalar(const FloorSpan &Span);
+	/**
+	 * SSE4.1 实现，一次处理 4 个像素
+	 */
+	template <unsigned Features>
+	void RenderFloorSpanSSE41(const FloorSpan &Span);
+	/**
+	 * AVX2 实现，一次处理 8 个像素
+	 */
+	template <unsigned Features>
+	void RenderFloorSpanAVX2(const FloorSpan &Span);
+}
@@ -27,7 +27,7 @@
 
 #pragma once
 
-#include <include/RCContext.h>
+#include <include/RCTexture.h>
 
 #include <thirdparty/vecmath/vecmath.hpp>
 #include <functional>
@@ -30,6 +30,8 @@
 #include <include/RCContext.h>
 #include <include/RCColor.h>
 
+#include <vector>
+
 /**
  * 一个对纹理进行封装的类
  */
@@ -58,12 +60,74 @@ public:
 	COLORREF ReadPixel(const int &Position) {
 		return _buffer[Position];
 	}
+	/**
+	 * 纹理是否完全不透明，即所有像素的 Alpha 通道均不为零。
+	 * 该值在构造时计算，之后对 Context 的修改不会更新该值
+	 * @return 若纹理完全不透明则返回 true，否则返回 false
+	 */
+	[[nodiscard]] bool IsOpaque() const;
+	/**
+	 * 获取 mipmap 的层级数，第 0 层即为原始纹理，之后每一层的宽高均为上一层的一半（向上取整），
+	 * 直到宽高均为 1。mipmap 在构造时生成，之后对 Context 的修改不会更新 mipmap
+	 * @return mipmap 的层级数
+	 */
+	[[nodiscard]] int GetMipLevelCount() const;
+	/**
+	 * 依据每个屏幕像素跨越的纹素数量选择 mipmap 层级，跨越的纹素越多，选择的层级越小
+	 * @param TexelsPerPixel 在第 0 层上，每个屏幕像素跨越的纹素数量
+	 * @return 选择的 mipmap 层级
+	 */
+	[[nodiscard]] int SelectMipLevel(const float &TexelsPerPixel) const;
+	/**
+	 * 生成或释放纹理（包括全部 mipmap 层级）按列存储的副本。墙体与精灵逐列采样纹理，
+	 * 按列存储时同一列的纹素是连续的；地板与天花板始终使用按行存储的纹理。默认不生成，
+	 * 生成后对 Context 的修改同样不会更新该副本，且不应在渲染过程中调用
+	 * @param Status 当为 true 时，则生成按列存储的副本，否则释放该副本
+	 */
+	void EnableColumnMajor(const bool &Status);
+	/**
+	 * 获取按列存储的副本占用的内存
+	 * @return 副本占用的字节数，未生成时为 0
+	 */
+	[[nodiscard]] size_t GetColumnMajorSize() const;
+
+private:
+	/**
+	 * 生成第 0 层之外的 mipmap
+	 */
+	void BuildMipChain();
 
 private:
 	friend class RCRenderer;
 	friend class RCMapDoor;
 
+private:
+	/**
+	 * mipmap 的一层
+	 */
+	struct MipLevel {
+		const DWORD *buffer;
+		/**
+		 * 按列存储的副本，第 x 列的纹素位于 [columnBuffer + x * height, columnBuffer + (x + 1) * height)，
+		 * 未生成时为 nullptr
+		 */
+		const DWORD *columnBuffer;
+		int          width;
+		int          height;
+	};
+
 private:
 	DWORD       *_buffer;
 	RCContext   *_context;
+	bool         _opaque;
+
+	std::vector<MipLevel> _mipLevels;
+	/**
+	 * 第 0 层之外所有层级的像素，第 0 层直接使用 Context 的缓冲区
+	 */
+	std::vector<DWORD>    _mipStorage;
+	/**
+	 * 全部层级按列存储的副本
+	 */
+	std::vector<DWORD>    _columnMajorStorage;
 };
\ No newline at end of file
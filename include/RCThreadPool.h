@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2023~Now Margoo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * \file RCThreadPool.h
+ * \brief 渲染器使用的常驻线程池
+ */
+
+#pragma once
+
+#include <include/RCException.h>
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * 常驻的线程池，每次分发时线程 i 执行 Task(i)，其中下标 0 的任务总是在调用线程上执行，
+ * 因此线程数为 1 时不会创建任何额外的线程
+ */
+class RCThreadPool {
+public:
+	/**
+	 * 创建线程池
+	 * @param ThreadCount 线程总数（包括调用线程），必须大于零
+	 */
+	explicit RCThreadPool(const int &ThreadCount);
+	~RCThreadPool();
+
+public:
+	/**
+	 * 获取线程总数（包括调用线程）
+	 * @return 线程总数
+	 */
+	[[nodiscard]] int GetThreadCount() const;
+	/**
+	 * 向所有线程分发任务，并阻塞直到所有线程完成该任务。即使任务抛出异常，也会等待所有线程完成后
+	 * 再将异常重新抛出，调用线程的异常优先，其次为工作线程中第一个抛出的异常
+	 * @param Task 任务函数，参数为线程的下标，取值范围为 [0, GetThreadCount())
+	 */
+	void Dispatch(const std::function<void(const int &)> &Task);
+
+private:
+	/**
+	 * 工作线程的主循环
+	 * @param Index 工作线程的下标
+	 */
+	void WorkerProcess(const int &Index);
+
+private:
+	std::vector<std::thread>                  _workers;
+	std::mutex                                _mutex;
+	std::condition_variable                   _taskCondition;
+	std::condition_variable                   _doneCondition;
+	const std::function<void(const int &)>   *_task;
+	// 本次分发中工作线程抛出的第一个异常
+	std::exception_ptr                        _exception;
+	unsigned long long                        _generation;
+	int                                       _pending;
+	bool                                      _exit;
+};
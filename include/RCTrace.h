@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2023~Now Margoo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/**
+ * \file RCTrace.h
+ * \brief 以 Chrome trace event 格式记录渲染与交互时间线的跟踪器
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <ostream>
+
+/**
+ * 全局的时间线跟踪器，记录各线程上带名称的时间区间，并导出为 Chrome 的 trace event JSON
+ * （可在 chrome://tracing 或 Perfetto 中打开），用于观察多线程渲染与交互逻辑的重叠与等待。
+ * 每个线程在第一次记录时获得自己的定长缓冲区，写入时只有本线程访问，无需加锁；缓冲区写满后
+ * 新的区间将被丢弃。跟踪默认关闭，关闭时 RCTraceScope 只读取一次原子变量
+ */
+class RCTracer {
+public:
+	/**
+	 * 每个线程的缓冲区最多保存的区间数
+	 */
+	static constexpr size_t BufferCapacity = 64 * 1024;
+
+public:
+	/**
+	 * 启用或关闭跟踪，关闭后已经记录的区间仍然保留
+	 * @param Status 当为 true 时，则启用跟踪
+	 */
+	static void Enable(const bool &Status);
+	/**
+	 * 跟踪是否已经启用
+	 * @return 跟踪启用时为 true
+	 */
+	[[nodiscard]] static bool IsEnabled() {
+		return _enabled.load(std::memory_order_relaxed);
+	}
+	/**
+	 * 设置调用线程在时间线中显示的名称
+	 * @param Name 线程的名称
+	 */
+	static void SetThreadName(const char *Name);
+	/**
+	 * 在调用线程的缓冲区中记录一个区间
+	 * @param Name 区间的名称，必须是生命周期足够长的字符串（通常为字符串字面量）
+	 * @param Category 区间的分类，要求同 Name
+	 * @param Start 区间的开始时刻
+	 * @param End 区间的结束时刻
+	 */
+	static void Record(const char *Name, const char *Category, const std::chrono::steady_clock::time_point &Start,
+	                   const std::chrono::steady_clock::time_point &End);
+	/**
+	 * 清空所有线程已经记录的区间，调用时其它线程不能正在记录区间（例如在两帧之间调用）
+	 */
+	static void Clear();
+	/**
+	 * 获取因缓冲区写满而被丢弃的区间数
+	 * @return 被丢弃的区间数
+	 */
+	[[nodiscard]] static size_t GetDroppedCount();
+	/**
+	 * 以 Chrome trace event JSON 格式输出所有线程已经记录的区间，可以在其它线程记录的同时调用
+	 * @param Stream 输出流
+	 */
+	static void WriteJSON(std::ostream &Stream);
+	/**
+	 * 将 WriteJSON 的结果写入文件
+	 * @param Path 文件路径
+	 */
+	static void DumpJSON(const char *Path);
+
+private:
+	static inline std::atomic<bool> _enabled{ false };
+};
+
+/**
+ * 在作用域内记录一个区间，跟踪关闭时不读取时钟
+ */
+class RCTraceScope {
+public:
+	explicit RCTraceScope(const char *Name, const char *Category = "RCEngine")
+	    : _name(RCTracer::IsEnabled() ? Name : nullptr), _category(Category) {
+		if (_name != nullptr) {
+			_start = std::chrono::steady_clock::now();
+		}
+	}
+	~RCTraceScope() {
+		if (_name != nullptr) {
+			RCTracer::Record(_name, _category, _start, std::chrono::steady_clock::now());
+		}
+	}
+
+	RCTraceScope(const RCTraceScope &) = delete;
+	RCTraceScope &operator=(const RCTraceScope &) = delete;
+
+private:
+	const char                           *_name;
+	const char                           *_category;
+	std::chrono::steady_clock::time_point _start;
+};
+
+#define RC_TRACE_CONCAT_IMPL(Left, Right) Left##Right
+#define RC_TRACE_CONCAT(Left, Right) RC_TRACE_CONCAT_IMPL(Left, Right)
+/**
+ * 在当前作用域内记录一个区间
+ */
+#define RC_TRACE_SCOPE(Name, Category) RCTraceScope RC_TRACE_CONCAT(_rcTraceScope, __LINE__)(Name, Category)
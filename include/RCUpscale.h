@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2023~Now Margoo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/**
+ * \file RCUpscale.h
+ * \brief 画面放大内核，用于将以较低分辨率渲染的画面放大到渲染目标上
+ */
+
+#pragma once
+
+#include <include/RCSpanKernel.h>
+
+namespace RCRender {
+	/**
+	 * 放大画面时使用的插值方式
+	 */
+	enum class UpscaleFilter {
+		// 最近邻插值，与 GDI 的 StretchBlt 结果一致
+		Nearest,
+		// 双线性插值，像素中心对齐
+		Bilinear
+	};
+
+	/**
+	 * 将 Source 左上角 SourceWidth x SourceHeight 的区域放大到 Target 左上角 TargetWidth x TargetHeight 的区域，
+	 * 只写入目标的 [RowStart, RowEnd) 行，以便多个线程分别放大不同的行
+	 */
+	using UpscaleKernel = void (*)(const DWORD *Source, const int &SourceStride, const int &SourceWidth,
+	                               const int &SourceHeight, DWORD *Target, const int &TargetStride,
+	                               const int &TargetWidth, const int &TargetHeight, const int &RowStart,
+	                               const int &RowEnd);
+
+	/**
+	 * 双线性插值在一个方向上的采样参数（16.16 定点数），目标第 i 个像素的中心对应源坐标
+	 * start + i * step，并需限制在 [0, limit] 之内
+	 */
+	struct BilinearAxis {
+		int start;
+		int step;
+		int limit;
+	};
+	/**
+	 * 构造双线性插值在一个方向上的采样参数
+	 * @param SourceSize 源区域在该方向上的大小
+	 * @param TargetSize 目标区域在该方向上的大小
+	 * @return 采样参数
+	 */
+	inline BilinearAxis MakeBilinearAxis(const int &SourceSize, const int &TargetSize) {
+		const int step = (SourceSize << 16) / TargetSize;
+		return {step / 2 - 32768, step, (SourceSize - 1) << 16};
+	}
+	/**
+	 * 以 8 位权重在两个像素之间逐通道插值并向下取整，即 (A * (256 - Weight) + B * Weight) >> 8。
+	 * 单个通道的结果不超过 16 位，因此可以一次处理两个通道
+	 * @param A 权重为零时的像素
+	 * @param B 另一个像素
+	 * @param Weight B 的权重，范围为 [0, 255]
+	 * @return 插值后的像素
+	 */
+	inline DWORD LerpPixel(const DWORD &A, const DWORD &B, const int &Weight) {
+		const DWORD inverse    = 256 - Weight;
+		const DWORD redBlue    = (((A & 0x00FF00FF) * inverse + (B & 0x00FF00FF) * Weight) >> 8) & 0x00FF00FF;
+		const DWORD alphaGreen = ((A >> 8) & 0x00FF00FF) * inverse + ((B >> 8) & 0x00FF00FF) * Weight;
+		return redBlue | (alphaGreen & 0xFF00FF00);
+	}
+
+	/**
+	 * 获取指定插值方式与指令集的放大内核
+	 * @param Filter 插值方式
+	 * @param Set 目标指令集，调用者需确保当前 CPU 支持该指令集
+	 * @return 放大内核，所有指令集的结果逐位相同
+	 */
+	UpscaleKernel GetUpscaleKernel(const UpscaleFilter &Filter, const InstructionSet &Set);
+
+	/**
+	 * 最近邻插值的标量实现，映射到同一源行的目标行直接复制上一行
+	 */
+	void UpscaleNearestScalar(const DWORD *Source, const int &SourceStride, const int &SourceWidth,
+	                          const int &SourceHeight, DWORD *Target, const int &TargetStride, const int &TargetWidth,
+	                          const int &TargetHeight, const int &RowStart, const int &RowEnd);
+	/**
+	 * 最近邻插值的 AVX2 实现，以 gather 指令一次读取 8 个像素
+	 */
+	void UpscaleNearestAVX2(const DWORD *Source, const int &SourceStride, const int &SourceWidth,
+	                        const int &SourceHeight, DWORD *Target, const int &TargetStride, const int &TargetWidth,
+	                        const int &TargetHeight, const int &RowStart, const int &RowEnd);
+	/**
+	 * 双线性插值的标量实现
+	 */
+	void UpscaleBilinearScalar(const DWORD *Source, const int &SourceStride, const int &SourceWidth,
+	                           const int &SourceHeight, DWORD *Target, const int &TargetStride, const int &TargetWidth,
+	                           const int &TargetHeight, const int &RowStart, const int &RowEnd);
+	/**
+	 * 双线性插值的 SSE4.1 实现，一次插值 4 个像素的 16 个通道
+	 */
+	void UpscaleBilinearSSE41(const DWORD *Source, const int &SourceStride, const int &SourceWidth,
+	                          const int &SourceHeight, DWORD *Target, const int &TargetStride, const int &TargetWidth,
+	                          const int &TargetHeight, const int &RowStart, const int &RowEnd);
+	/**
+	 * 双线性插值的 AVX2 实现，以 gather 指令一次读取并插值 8 个像素
+	 */
+	void UpscaleBilinearAVX2(const DWORD *Source, const int &SourceStride, const int &SourceWidth,
+	                         const int &SourceHeight, DWORD *Target, const int &TargetStride, const int &TargetWidth,
+	                         const int &TargetHeight, const int &RowStart, const int &RowEnd);
+}
@@ -146,7 +146,10 @@ int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PWSTR pCmdLine
 		outtextxy(20, 50, _T("   按下 'ESC' 退出"));
 		outtextxy(20, 63, _T("   'W' 'S' 'A' 'D' 左右移动"));
 		outtextxy(20, 76, _T("   'ctrl' 潜行 'shift' 疾跑"));
-		renderTarget->Flush();
+		{
+			RCProfileScope flushScope(renderer.GetProfiler(), RCProfileStage::Flush);
+			renderTarget->Flush();
+		}
 	}
 
 
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2023~Now Margoo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * \file RCColumnKernel.cpp
+ * \brief 列内核的模板实现与特化实例表
+ */
+
+#include <include/RCColumnKernel.h>
+
+#include <array>
+#include <utility>
+
+namespace RCRender {
+	namespace {
+		template <unsigned Features>
+		void RenderColumn(const ColumnSpan &Span) {
+			constexpr bool fog   = (Features & ColumnFeature::Fog) != 0;
+			constexpr bool blend = (Features & ColumnFeature::Blend) != 0;
+			constexpr int  shade = static_cast<int>(Features >> 2);
+
+			const int stride   = Span.outputStride;
+			DWORD    *output   = Span.output + Span.begin * stride;
+			int       textureY = Span.textureY;
+			long long position = Span.stepper.position;
+			for (int y = Span.begin; y < Span.end; ++y, output += stride) {
+				COLORREF color = Span.texels[textureY * Span.texelStride];
+				// 如果 Alpha 通道不为零，则绘制
+				if ((color & 0xFF000000) != 0) {
+					if constexpr (fog) {
+						// 明暗面与烟雾一并通过颜色表处理
+						color = RGB(Span.colormap[GetRValue(color) >> shade], Span.colormap[256 + (GetGValue(color) >> shade)],
+						            Span.colormap[512 + (GetBValue(color) >> shade)]);
+					} else if constexpr (shade == 1) {
+						color = (color >> 1) & 8355711;
+					} else if constexpr (shade == 2) {
+						color = (color >> 2) & 0x3F3F3F;
+					}
+					if constexpr (blend) {
+						color = ((color & 0xFEFEFE) >> 1) + ((*output & 0xFEFEFE) >> 1);
+					}
+					*output = color;
+				}
+
+				textureY  = GetStepperTexel(position);
+				position += Span.stepper.step;
+			}
+		}
+
+		template <std::size_t... Features>
+		constexpr std::array<ColumnKernel, sizeof...(Features)> MakeColumnKernels(std::index_sequence<Features...>) {
+			return { RenderColumn<static_cast<unsigned>(Features)>... };
+		}
+
+		constexpr auto ColumnKernels = MakeColumnKernels(std::make_index_sequence<ColumnFeature::Count>());
+	}
+
+	ColumnKernel GetColumnKernel(const unsigned &Features) {
+		return ColumnKernels[Features];
+	}
+}
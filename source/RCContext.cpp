@@ -27,6 +27,7 @@
 
 #include <include/RCContext.h>
 
+#ifdef _RC_BACKEND_EASYX_
 RCContext::RCContext() {
 	_context = nullptr;
 	// 检查是否已经创建了窗口
@@ -38,6 +39,7 @@ RCContext::RCContext(const int &Width, const int &Height) {
 	_context = new IMAGE(Width, Height);
 }
 RCContext::RCContext(const TCHAR *ResourceType, const TCHAR *ResourceName) {
+	_context = new IMAGE;
 	loadimage(_context, ResourceType, ResourceName);
 }
 RCContext::RCContext(const TCHAR *FilePath) {
@@ -49,6 +51,9 @@ RCContext::RCContext(const TCHAR *FilePath) {
 		throw RCCreationFailure("RCContext");
 	}
 }
+RCContext::~RCContext() {
+	delete _context;
+}
 int RCContext::GetWidth() const{
 	if (_context != nullptr) {
 		return _context->getwidth();
@@ -63,6 +68,119 @@ int RCContext::GetHeight() const {
 
 	return getheight();
 }
+DWORD *RCContext::GetBuffer() const {
+	return GetImageBuffer(_context);
+}
 void RCContext::Resize(const int &Width, const int &Height) {
 	::Resize(_context, Width, Height);
-}
\ No newline at end of file
+}
+#else
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <new>
+
+namespace {
+	DWORD *AllocateBuffer(const int &Width, const int &Height) {
+		const auto size   = static_cast<size_t>(Width) * static_cast<size_t>(Height) * sizeof(DWORD);
+		auto       buffer = static_cast<DWORD *>(::operator new[](size, std::align_val_t(RCContext::BufferAlignment)));
+		memset(buffer, 0, size);
+
+		return buffer;
+	}
+	void FreeBuffer(DWORD *Buffer) {
+		::operator delete[](Buffer, std::align_val_t(RCContext::BufferAlignment));
+	}
+	/**
+	 * 读取 PPM 文件头中的一个数字，会跳过空白与注释
+	 */
+	bool ReadPPMNumber(std::ifstream &Stream, int &Value) {
+		int character = Stream.get();
+		while (character != EOF) {
+			if (character == '#') {
+				while (character != EOF && character != '\n') {
+					character = Stream.get();
+				}
+			} else if (!isspace(character)) {
+				break;
+			}
+			character = Stream.get();
+		}
+		if (character == EOF || !isdigit(character)) {
+			return false;
+		}
+
+		Value = 0;
+		while (character != EOF && isdigit(character)) {
+			Value     = Value * 10 + (character - '0');
+			character = Stream.get();
+		}
+
+		return true;
+	}
+}
+
+RCContext::RCContext() : _buffer(nullptr), _width(0), _height(0) {
+	// 无头后端不存在窗口
+	throw RCWindowHaveNotCreated();
+}
+RCContext::RCContext(const int &Width, const int &Height) : _width(Width), _height(Height) {
+	if (Width <= 0 || Height <= 0) {
+		throw RCInvalidParameterException("non-positive size", "RCContext construction");
+	}
+	_buffer = AllocateBuffer(_width, _height);
+}
+RCContext::RCContext(const TCHAR *, const TCHAR *) : _buffer(nullptr), _width(0), _height(0) {
+	// 无头后端不支持 Windows 资源文件
+	throw RCCreationFailure("RCContext from resource");
+}
+RCContext::RCContext(const TCHAR *FilePath) : _buffer(nullptr), _width(0), _height(0) {
+	std::ifstream stream(FilePath, std::ios::binary);
+	int           maxValue = 0;
+	if (!stream.is_open() || stream.get() != 'P' || stream.get() != '6' ||
+	    !ReadPPMNumber(stream, _width) || !ReadPPMNumber(stream, _height) ||
+	    !ReadPPMNumber(stream, maxValue) || maxValue != 255) {
+		throw RCCreationFailure("RCContext");
+	}
+
+	// 判断是否加载成功
+	if (_width == 0 || _height == 0) {
+		throw RCCreationFailure("RCContext");
+	}
+
+	_buffer = AllocateBuffer(_width, _height);
+	for (int count = 0; count < _width * _height; ++count) {
+		BYTE pixel[3];
+		if (!stream.read(reinterpret_cast<char *>(pixel), 3)) {
+			FreeBuffer(_buffer);
+			throw RCCreationFailure("RCContext");
+		}
+		// 与 EasyX 的图像缓冲区相同，使用 0xAARRGGBB 格式储存
+		_buffer[count] = 0xFF000000 | (pixel[0] << 16) | (pixel[1] << 8) | pixel[2];
+	}
+}
+RCContext::~RCContext() {
+	if (_buffer != nullptr) {
+		FreeBuffer(_buffer);
+	}
+}
+int RCContext::GetWidth() const {
+	return _width;
+}
+int RCContext::GetHeight() const {
+	return _height;
+}
+DWORD *RCContext::GetBuffer() const {
+	return _buffer;
+}
+void RCContext::Resize(const int &Width, const int &Height) {
+	if (Width <= 0 || Height <= 0) {
+		throw RCInvalidParameterException("non-positive size", "RCContext.Resize");
+	}
+
+	FreeBuffer(_buffer);
+	_width  = Width;
+	_height = Height;
+	_buffer = AllocateBuffer(_width, _height);
+}
+#endif
\ No newline at end of file
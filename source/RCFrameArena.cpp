@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2023~Now Margoo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/**
+ * \file RCFrameArena.cpp
+ * \brief 渲染器使用的帧内存分配器
+ */
+
+#include <include/RCFrameArena.h>
+#include <include/RCException.h>
+
+#include <algorithm>
+
+RCFrameArena::RCFrameArena(const size_t &BlockSize) : _offset(0), _usedBefore(0), _lastAllocation(nullptr) {
+	if (BlockSize == 0) {
+		throw RCInvalidParameterException("zero block size", "RCFrameArena construction");
+	}
+
+	AppendBlock(BlockSize);
+}
+RCFrameArena::~RCFrameArena() {
+	for (auto &block : _blocks) {
+		::operator delete[](block.memory, std::align_val_t(BlockAlignment));
+	}
+}
+void RCFrameArena::AppendBlock(const size_t &Size) {
+	auto memory = static_cast<unsigned char *>(::operator new[](Size, std::align_val_t(BlockAlignment)));
+	_blocks.push_back({memory, Size});
+}
+void *RCFrameArena::AllocateBytes(const size_t &Size, const size_t &Alignment) {
+	auto  &block   = _blocks.back();
+	size_t aligned = (_offset + Alignment - 1) & ~(Alignment - 1);
+	if (aligned + Size > block.size) {
+		// 当前内存块放不下时追加一块新的内存块，块大小至少翻倍以减少追加次数
+		_usedBefore += _offset;
+		AppendBlock(std::max(block.size * 2, Size + BlockAlignment));
+
+		aligned = 0;
+	}
+
+	_lastAllocation = _blocks.back().memory + aligned;
+	_offset         = aligned + Size;
+
+	return _lastAllocation;
+}
+bool RCFrameArena::GrowInPlace(void *Pointer, const size_t &Size, const size_t &NewSize) {
+	auto pointer = static_cast<unsigned char *>(Pointer);
+	if (pointer != _lastAllocation || pointer + Size != _blocks.back().memory + _offset) {
+		return false;
+	}
+	if (static_cast<size_t>(pointer - _blocks.back().memory) + NewSize > _blocks.back().size) {
+		return false;
+	}
+
+	_offset = static_cast<size_t>(pointer - _blocks.back().memory) + NewSize;
+
+	return true;
+}
+void RCFrameArena::Reset() {
+	// 上一帧用到了多块内存时，将它们合并为一块足够大的内存块
+	if (_blocks.size() > 1) {
+		size_t capacity = GetCapacity();
+		for (auto &block : _blocks) {
+			::operator delete[](block.memory, std::align_val_t(BlockAlignment));
+		}
+		_blocks.clear();
+
+		AppendBlock(capacity);
+	}
+
+	_offset         = 0;
+	_usedBefore     = 0;
+	_lastAllocation = nullptr;
+}
+size_t RCFrameArena::GetUsedSize() const {
+	return _usedBefore + _offset;
+}
+size_t RCFrameArena::GetCapacity() const {
+	size_t capacity = 0;
+	for (auto &block : _blocks) {
+		capacity += block.size;
+	}
+
+	return capacity;
+}
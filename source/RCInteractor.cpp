@@ -26,6 +26,7 @@
  */
 
 #include <include/RCInteractor.h>
+#include <include/RCTrace.h>
 
 RCInteractor::RCInteractor(RCCamera *Camera, RCVideoWindow *Window, RCMap *Map, RCScene *Scene)
     : _camera(Camera), _window(Window), _map(Map), MoveSpeed(4.5f), PitchSpeed(1.8f), RotateSpeed(3.1415926 / 2),
@@ -35,6 +36,8 @@ RCInteractor::RCInteractor(RCCamera *Camera, RCVideoWindow *Window, RCMap *Map,
 	_renderTargetWidth = Window->_width;
 }
 void RCInteractor::SpriteInteractor() {
+	RC_TRACE_SCOPE("SpriteInteractor", "interact");
+
 	for (int count = 0; count < _scene->SpriteCount; ++count) {
 		auto sprite = _scene->SpriteList[count];
 		auto distance = sqrt(pow(sprite->x - _camera->Position.x, 2) + pow(sprite->y - _camera->Position.y, 2));
@@ -63,68 +66,37 @@ void RCInteractor::ProcessMessage(const ExMessage &Message, const float &FrameRa
 			if (keyBind != _keyBind.end()) {
 				switch (keyBind->second) {
 					case RCInteractType::Interact: {
-						for (int x = 0; x < _renderTargetWidth; ++x) {
-							float cameraX                       = 2.f * static_cast<float>(x) / static_cast<float>(_renderTargetWidth) - 1;
-							vecmath::Vector<float> rayDirection = _camera->Direction + _camera->Plane * cameraX;
-							int mapX                            = static_cast<int>(_camera->Position.x);
-							int mapY                            = static_cast<int>(_camera->Position.y);
-
-							RCRender::MapObject object{};
-							float sideDistanceX;
-							float sideDistanceY;
-							float deltaDistanceX = std::abs(1.f / rayDirection.x);
-							float deltaDistanceY = std::abs(1.f / rayDirection.y);
-							float perpDistance;
-							float wallX;
-
-							int stepX;
-							int stepY;
-
-							if (rayDirection.x < 0) {
-								stepX         = -1;
-								sideDistanceX = (_camera->Position.x - static_cast<float>(mapX)) * deltaDistanceX;
-							} else {
-								stepX         = 1;
-								sideDistanceX = (static_cast<float>(mapX) + 1.f - _camera->Position.x) * deltaDistanceX;
-							}
-							if (rayDirection.y < 0) {
-								stepY         = -1;
-								sideDistanceY = (_camera->Position.y - static_cast<float>(mapY)) * deltaDistanceY;
-							} else {
-								stepY         = 1;
-								sideDistanceY = (static_cast<float>(mapY) + 1.f - _camera->Position.y) * deltaDistanceY;
-							}
-
+						auto map = _scene->_map;
+						// 沿光线检查玩家指向的位置是否有可交互的物体，浮点数与定点数光线的步进规则相同，
+						// 只有距离的表示不同，HalfDelta 求半格的距离，ToDistance 将距离转换为浮点数
+						auto interact = [&](auto &Ray, auto &&HalfDelta, auto &&ToDistance) {
 							RCRender::HideSide hitSide;
-
-							// 检查玩家指向的位置是否有可交互的物体
 							while (true) {
-								if (sideDistanceX < sideDistanceY) {
-									sideDistanceX += deltaDistanceX;
-									mapX += stepX;
+								map->SkipEmptySpace(Ray);
+								if (Ray.Step()) {
 									hitSide = RCRender::HideSide::NS;
 								} else {
-									sideDistanceY += deltaDistanceY;
-									mapY += stepY;
 									hitSide = RCRender::HideSide::EW;
 								}
-								RCMapUnit mapUnit = _scene->_map->_mapArray[mapX + mapY * _scene->_map->_width];
-								if (mapUnit.Type != RCMapUnitType::Air && mapUnit.Type != RCMapUnitType::Door) {
+								const RCMapUnit mapUnit = map->GetMapUnit(Ray.mapX + Ray.mapY * map->_width);
+								const auto     &traits  = GetMapUnitTraits(mapUnit.Type);
+								if (traits.shape != RCMapUnitShape::None && !traits.door) {
 									break;
 								}
-								else if (mapUnit.Type != RCMapUnitType::Air) {
+								else if (traits.door) {
+									float perpDistance;
 									if (hitSide == RCRender::HideSide::NS) {
-										float distance = sideDistanceX - deltaDistanceX * 0.5f;
-										if (sideDistanceY < distance) {
+										auto distance = Ray.sideDistanceX - HalfDelta(Ray.deltaDistanceX);
+										if (Ray.sideDistanceY < distance) {
 											continue;
 										}
-										perpDistance = distance;
+										perpDistance = ToDistance(distance);
 									} else {
-										float distance = sideDistanceY - deltaDistanceY * 0.5f;
-										if (sideDistanceX < distance) {
+										auto distance = Ray.sideDistanceY - HalfDelta(Ray.deltaDistanceY);
+										if (Ray.sideDistanceX < distance) {
 											continue;
 										}
-										perpDistance = distance;
+										perpDistance = ToDistance(distance);
 									}
 									if (perpDistance > Reach) {
 										break;
@@ -134,12 +106,36 @@ void RCInteractor::ProcessMessage(const ExMessage &Message, const float &FrameRa
 											mapUnit.Door->_animationStatus = !mapUnit.Door->_animationStatus;
 											mapUnit.Door->_inAnimation     = true;
 
-											_inAnimationDoor.push_back(&_scene->_map->_mapArray[mapX + mapY * _scene->_map->_width]);
+											_inAnimationDoor.push_back(mapUnit.Door);
 										}
 										break;
 									}
 								}
 							}
+						};
+
+						if (_scene->_enableFixedPointTraversal) {
+							// 与渲染器相同，以量化后的相机求出每一列的定点数光线
+							const int positionX  = RCMapFixedRay::ToFixed(_camera->Position.x);
+							const int positionY  = RCMapFixedRay::ToFixed(_camera->Position.y);
+							const int directionX = RCMapFixedRay::ToFixed(_camera->Direction.x);
+							const int directionY = RCMapFixedRay::ToFixed(_camera->Direction.y);
+							const int planeX     = RCMapFixedRay::ToFixed(_camera->Plane.x);
+							const int planeY     = RCMapFixedRay::ToFixed(_camera->Plane.y);
+							for (int x = 0; x < _renderTargetWidth; ++x) {
+								const auto column = RCRender::MakeFixedColumn(directionX, directionY, planeX, planeY, x,
+								                                              _renderTargetWidth);
+								RCMapFixedRay ray(positionX, positionY, column.directionX, column.directionY,
+								                  column.deltaDistanceX, column.deltaDistanceY);
+								interact(ray, [](const long long &Delta) { return Delta >> 1; }, &RCMapFixedRay::ToFloat);
+							}
+						} else {
+							for (int x = 0; x < _renderTargetWidth; ++x) {
+								float cameraX                       = 2.f * static_cast<float>(x) / static_cast<float>(_renderTargetWidth) - 1;
+								vecmath::Vector<float> rayDirection = _camera->Direction + _camera->Plane * cameraX;
+								RCMapRay ray(_camera->Position, rayDirection);
+								interact(ray, [](const float &Delta) { return Delta * 0.5f; }, [](const float &Distance) { return Distance; });
+							}
 						}
 
 						break;
@@ -272,32 +268,34 @@ void RCInteractor::ProcessMessage(const ExMessage &Message, const float &FrameRa
 	}
 }
 void RCInteractor::FrameProcess(const float &FrameRate) {
+	RC_TRACE_SCOPE("FrameProcess", "interact");
+
 	auto actualSpeed = MoveSpeed * FrameRate * _moveSpeedFactor;
 	if (_keyStatus[RCInteractType::W]) {
 		auto xDelta = _camera->Direction.x * actualSpeed;
 		auto yDelta = _camera->Direction.y * actualSpeed;
-		auto mapUnitX = _map->_mapArray[_map->_width * int(_camera->Position.y) + int(_camera->Position.x + xDelta)];
-		auto mapUnitY = _map->_mapArray[_map->_width * int(_camera->Position.y + yDelta) + int(_camera->Position.x)];
-		bool doorPassableX = mapUnitX.Type == RCMapUnitType::Door && mapUnitX.Door->Offset == mapUnitX.Door->Min && !mapUnitX.Door->_inAnimation;
-		bool doorPassableY = mapUnitY.Type == RCMapUnitType::Door && mapUnitY.Door->Offset == mapUnitY.Door->Min && !mapUnitY.Door->_inAnimation;
-		if (mapUnitX.Passable || mapUnitX.Type == RCMapUnitType::Air || doorPassableX) {
+		auto mapUnitX = _map->GetMapUnit(_map->_width * int(_camera->Position.y) + int(_camera->Position.x + xDelta));
+		auto mapUnitY = _map->GetMapUnit(_map->_width * int(_camera->Position.y + yDelta) + int(_camera->Position.x));
+		bool doorPassableX = GetMapUnitTraits(mapUnitX.Type).door && mapUnitX.Door->Offset == mapUnitX.Door->Min && !mapUnitX.Door->_inAnimation;
+		bool doorPassableY = GetMapUnitTraits(mapUnitY.Type).door && mapUnitY.Door->Offset == mapUnitY.Door->Min && !mapUnitY.Door->_inAnimation;
+		if (mapUnitX.Passable || GetMapUnitTraits(mapUnitX.Type).passable || doorPassableX) {
 			_camera->Position.x += xDelta;
 		}
-		if (mapUnitY.Passable || mapUnitY.Type == RCMapUnitType::Air || doorPassableY) {
+		if (mapUnitY.Passable || GetMapUnitTraits(mapUnitY.Type).passable || doorPassableY) {
 			_camera->Position.y += yDelta;
 		}
 	}
 	if (_keyStatus[RCInteractType::S]) {
 		auto xDelta = _camera->Direction.x * -actualSpeed;
 		auto yDelta = _camera->Direction.y * -actualSpeed;
-		auto mapUnitX = _map->_mapArray[_map->_width * int(_camera->Position.y) + int(_camera->Position.x + xDelta)];
-		auto mapUnitY = _map->_mapArray[_map->_width * int(_camera->Position.y + yDelta) + int(_camera->Position.x)];
-		bool doorPassableX = mapUnitX.Type == RCMapUnitType::Door && mapUnitX.Door->Offset == mapUnitX.Door->Min && !mapUnitX.Door->_inAnimation;
-		bool doorPassableY = mapUnitY.Type == RCMapUnitType::Door && mapUnitY.Door->Offset == mapUnitY.Door->Min && !mapUnitY.Door->_inAnimation;
-		if (mapUnitX.Passable || mapUnitX.Type == RCMapUnitType::Air || doorPassableX) {
+		auto mapUnitX = _map->GetMapUnit(_map->_width * int(_camera->Position.y) + int(_camera->Position.x + xDelta));
+		auto mapUnitY = _map->GetMapUnit(_map->_width * int(_camera->Position.y + yDelta) + int(_camera->Position.x));
+		bool doorPassableX = GetMapUnitTraits(mapUnitX.Type).door && mapUnitX.Door->Offset == mapUnitX.Door->Min && !mapUnitX.Door->_inAnimation;
+		bool doorPassableY = GetMapUnitTraits(mapUnitY.Type).door && mapUnitY.Door->Offset == mapUnitY.Door->Min && !mapUnitY.Door->_inAnimation;
+		if (mapUnitX.Passable || GetMapUnitTraits(mapUnitX.Type).passable || doorPassableX) {
 			_camera->Position.x += xDelta;
 		}
-		if (mapUnitY.Passable || mapUnitY.Type == RCMapUnitType::Air || doorPassableY) {
+		if (mapUnitY.Passable || GetMapUnitTraits(mapUnitY.Type).passable || doorPassableY) {
 			_camera->Position.y += yDelta;
 		}
 	}
@@ -311,14 +309,14 @@ void RCInteractor::FrameProcess(const float &FrameRate) {
 		auto perpDirection = rotationMatrix.transform(_camera->Direction);
 		auto xDelta = perpDirection.x * -actualSpeed;
 		auto yDelta = perpDirection.y * -actualSpeed;
-		auto mapUnitX = _map->_mapArray[_map->_width * int(_camera->Position.y) + int(_camera->Position.x + xDelta)];
-		auto mapUnitY = _map->_mapArray[_map->_width * int(_camera->Position.y + yDelta) + int(_camera->Position.x)];
-		bool doorPassableX = mapUnitX.Type == RCMapUnitType::Door && mapUnitX.Door->Offset == mapUnitX.Door->Min && !mapUnitX.Door->_inAnimation;
-		bool doorPassableY = mapUnitY.Type == RCMapUnitType::Door && mapUnitY.Door->Offset == mapUnitY.Door->Min && !mapUnitY.Door->_inAnimation;
-		if (mapUnitX.Passable || mapUnitX.Type == RCMapUnitType::Air || doorPassableX) {
+		auto mapUnitX = _map->GetMapUnit(_map->_width * int(_camera->Position.y) + int(_camera->Position.x + xDelta));
+		auto mapUnitY = _map->GetMapUnit(_map->_width * int(_camera->Position.y + yDelta) + int(_camera->Position.x));
+		bool doorPassableX = GetMapUnitTraits(mapUnitX.Type).door && mapUnitX.Door->Offset == mapUnitX.Door->Min && !mapUnitX.Door->_inAnimation;
+		bool doorPassableY = GetMapUnitTraits(mapUnitY.Type).door && mapUnitY.Door->Offset == mapUnitY.Door->Min && !mapUnitY.Door->_inAnimation;
+		if (mapUnitX.Passable || GetMapUnitTraits(mapUnitX.Type).passable || doorPassableX) {
 			_camera->Position.x += xDelta;
 		}
-		if (mapUnitY.Passable || mapUnitY.Type == RCMapUnitType::Air || doorPassableY) {
+		if (mapUnitY.Passable || GetMapUnitTraits(mapUnitY.Type).passable || doorPassableY) {
 			_camera->Position.y += yDelta;
 		}
 	}
@@ -332,35 +330,37 @@ void RCInteractor::FrameProcess(const float &FrameRate) {
 		auto perpDirection = rotationMatrix.transform(_camera->Direction);
 		auto xDelta = perpDirection.x * actualSpeed;
 		auto yDelta = perpDirection.y * actualSpeed;
-		auto mapUnitX = _map->_mapArray[_map->_width * int(_camera->Position.y) + int(_camera->Position.x + xDelta)];
-		auto mapUnitY = _map->_mapArray[_map->_width * int(_camera->Position.y + yDelta) + int(_camera->Position.x)];
-		bool doorPassableX = mapUnitX.Type == RCMapUnitType::Door && mapUnitX.Door->Offset == mapUnitX.Door->Min && !mapUnitX.Door->_inAnimation;
-		bool doorPassableY = mapUnitY.Type == RCMapUnitType::Door && mapUnitY.Door->Offset == mapUnitY.Door->Min && !mapUnitY.Door->_inAnimation;
-		if (mapUnitX.Passable || mapUnitX.Type == RCMapUnitType::Air || doorPassableX) {
+		auto mapUnitX = _map->GetMapUnit(_map->_width * int(_camera->Position.y) + int(_camera->Position.x + xDelta));
+		auto mapUnitY = _map->GetMapUnit(_map->_width * int(_camera->Position.y + yDelta) + int(_camera->Position.x));
+		bool doorPassableX = GetMapUnitTraits(mapUnitX.Type).door && mapUnitX.Door->Offset == mapUnitX.Door->Min && !mapUnitX.Door->_inAnimation;
+		bool doorPassableY = GetMapUnitTraits(mapUnitY.Type).door && mapUnitY.Door->Offset == mapUnitY.Door->Min && !mapUnitY.Door->_inAnimation;
+		if (mapUnitX.Passable || GetMapUnitTraits(mapUnitX.Type).passable || doorPassableX) {
 			_camera->Position.x += xDelta;
 		}
-		if (mapUnitY.Passable || mapUnitY.Type == RCMapUnitType::Air || doorPassableY) {
+		if (mapUnitY.Passable || GetMapUnitTraits(mapUnitY.Type).passable || doorPassableY) {
 			_camera->Position.y += yDelta;
 		}
 	}
 }
 void RCInteractor::ProcessDoorAnimation(const float &FrameRate) {
+	RC_TRACE_SCOPE("ProcessDoorAnimation", "interact");
+
 	for (int count = 0; count < _inAnimationDoor.size(); ++count) {
-		float offsetSymbol = _inAnimationDoor[count]->Door->_animationStatus ? -1.f : 1.f;
-		_inAnimationDoor[count]->Door->Offset += offsetSymbol * _inAnimationDoor[count]->Door->Speed * FrameRate;
-		_inAnimationDoor[count]->Door->Offset = _inAnimationDoor[count]->Door->Offset < _inAnimationDoor[count]->Door->Min ? _inAnimationDoor[count]->Door->Min : _inAnimationDoor[count]->Door->Offset;
-		_inAnimationDoor[count]->Door->Offset = _inAnimationDoor[count]->Door->Offset < static_cast<float>(_inAnimationDoor[count]->Door->Max) ?
-		                                                                                                                   _inAnimationDoor[count]->Door->Offset : _inAnimationDoor[count]->Door->Max;
-		if (!_inAnimationDoor[count]->Door->_animationStatus &&
-		    _inAnimationDoor[count]->Door->Offset == _inAnimationDoor[count]->Door->Max) {
-			_inAnimationDoor[count]->Door->_inAnimation = false;
+		float offsetSymbol = _inAnimationDoor[count]->_animationStatus ? -1.f : 1.f;
+		_inAnimationDoor[count]->Offset += offsetSymbol * _inAnimationDoor[count]->Speed * FrameRate;
+		_inAnimationDoor[count]->Offset = _inAnimationDoor[count]->Offset < _inAnimationDoor[count]->Min ? _inAnimationDoor[count]->Min : _inAnimationDoor[count]->Offset;
+		_inAnimationDoor[count]->Offset = _inAnimationDoor[count]->Offset < static_cast<float>(_inAnimationDoor[count]->Max) ?
+		                                                                                                                   _inAnimationDoor[count]->Offset : _inAnimationDoor[count]->Max;
+		if (!_inAnimationDoor[count]->_animationStatus &&
+		    _inAnimationDoor[count]->Offset == _inAnimationDoor[count]->Max) {
+			_inAnimationDoor[count]->_inAnimation = false;
 			_inAnimationDoor.erase(_inAnimationDoor.begin() + count);
 			--count;
 			continue;
 		}
-		if (_inAnimationDoor[count]->Door->_animationStatus &&
-		    _inAnimationDoor[count]->Door->Offset == _inAnimationDoor[count]->Door->Min) {
-			_inAnimationDoor[count]->Door->_inAnimation = false;
+		if (_inAnimationDoor[count]->_animationStatus &&
+		    _inAnimationDoor[count]->Offset == _inAnimationDoor[count]->Min) {
+			_inAnimationDoor[count]->_inAnimation = false;
 			_inAnimationDoor.erase(_inAnimationDoor.begin() + count);
 			--count;
 			continue;
@@ -368,6 +368,8 @@ void RCInteractor::ProcessDoorAnimation(const float &FrameRate) {
 	}
 }
 void RCInteractor::Interact(const float &frame) {
+	RC_TRACE_SCOPE("Interact", "interact");
+
 	auto        frameRate = frame < 0.001f ? 0.001f : frame;
 	ExMessage   message{};
 	while (_window->Message(&message) && message.message != RCViewLookChange) {
@@ -27,21 +27,262 @@
 
 #include <include/RCMap.h>
 
+#include <algorithm>
+
 RCMapDoor::RCMapDoor(RCTexture* Texture) : Offset(Texture->_context->GetWidth()), Max(Texture->_context->GetWidth()), Speed(40), Min(Texture->_context->GetWidth() / 6) {
 
 }
 RCMap::RCMap(const int &Width, const int &Height, RCMapUnit *MapPointer)
-	: _width(Width), _height(Height), _mapArray(MapPointer) {
-	if (_mapArray == nullptr) {
+	: _width(Width), _height(Height), _version(0) {
+	if (MapPointer == nullptr) {
 		throw RCInvalidParameterException("nullptr", "RCMap construction");
 	}
+
+	const size_t size = static_cast<size_t>(_width) * _height;
+	_typeArray.resize(size);
+	_textureIndexArray.resize(size);
+	_textureTable.push_back(nullptr);
+	for (int position = 0; position < static_cast<int>(size); ++position) {
+		StoreMapUnit(position, MapPointer[position]);
+	}
+	delete[] MapPointer;
+
+	_distanceField.resize(size + 3);
+	RebuildDistanceField(0, 0, _width - 1, _height - 1);
+}
+const RCMapUnit RCMap::GetMapUnit(const int &Position) const {
+	RCMapUnit unit{};
+	unit.Texture  = GetMapUnitTexture(Position);
+	unit.Type     = GetMapUnitType(Position);
+	unit.Door     = GetMapUnitDoor(Position);
+	unit.Passable = IsPassable(Position);
+
+	return unit;
+}
+RCMapDoor *RCMap::GetMapUnitDoor(const int &Position) const {
+	auto door = _doorTable.find(Position);
+
+	return door == _doorTable.end() ? nullptr : door->second;
+}
+void RCMap::SetMapUnit(const int &Position, const RCMapUnit &Unit) {
+	if (Position < 0 || Position >= _width * _height) {
+		throw RCInvalidParameterException("Position out of range", "RCMap.SetMapUnit");
+	}
+
+	const bool changed = (GetMapUnitTraits(GetMapUnitType(Position)).shape == RCMapUnitShape::None) !=
+	                     (GetMapUnitTraits(Unit.Type).shape == RCMapUnitShape::None);
+	StoreMapUnit(Position, Unit);
+	++_version;
+	if (changed) {
+		UpdateDistanceField(Position);
+	}
+}
+void RCMap::StoreMapUnit(const int &Position, const RCMapUnit &Unit) {
+	_typeArray[Position]         = static_cast<unsigned char>(Unit.Type) | (Unit.Passable ? PassableFlag : 0);
+	_textureIndexArray[Position] = GetTextureIndex(Unit.Texture);
+	if (Unit.Door != nullptr) {
+		_doorTable[Position] = Unit.Door;
+	} else {
+		_doorTable.erase(Position);
+	}
 }
-RCMapUnit& RCMap::GetMapUnit(const int &Position) {
-	return _mapArray[Position];
+unsigned short RCMap::GetTextureIndex(RCTexture *Texture) {
+	if (Texture == nullptr) {
+		return 0;
+	}
+
+	auto index = _textureIndexTable.find(Texture);
+	if (index != _textureIndexTable.end()) {
+		return index->second;
+	}
+	if (_textureTable.size() >= MaxTextureCount) {
+		throw RCInvalidParameterException("Too many textures", "RCMap.SetMapUnit");
+	}
+
+	const auto newIndex = static_cast<unsigned short>(_textureTable.size());
+	_textureTable.push_back(Texture);
+	_textureIndexTable.insert({Texture, newIndex});
+
+	return newIndex;
+}
+void RCMap::UpdateDistanceField(const int &Position) {
+	const int x = Position % _width;
+	const int y = Position / _width;
+
+	// 距离场满足 1-Lipschitz 条件，若第 k 圈上所有单位的距离都小于 k，则它们最近的非空气单位都不是被修改的单位，
+	// 更外圈的单位同样不受影响，只需重新计算第 k 圈以内的区域
+	int radius = 1;
+	for (; radius <= MaxEmptyDistance; ++radius) {
+		bool affected = false;
+		for (int offset = -radius; offset <= radius && !affected; ++offset) {
+			const int ringX[] = {x + offset, x + offset, x - radius, x + radius};
+			const int ringY[] = {y - radius, y + radius, y + offset, y + offset};
+			for (int count = 0; count < 4; ++count) {
+				if (ringX[count] >= 0 && ringX[count] < _width && ringY[count] >= 0 && ringY[count] < _height &&
+				    _distanceField[ringX[count] + ringY[count] * _width] >= radius) {
+					affected = true;
+
+					break;
+				}
+			}
+		}
+		if (!affected) {
+			break;
+		}
+	}
+
+	RebuildDistanceField(std::max(x - radius + 1, 0), std::max(y - radius + 1, 0),
+	                     std::min(x + radius - 1, _width - 1), std::min(y + radius - 1, _height - 1));
+}
+void RCMap::RebuildDistanceField(const int &Left, const int &Top, const int &Right, const int &Bottom) {
+	// 区域外的距离，地图之外视为非空气
+	auto distance = [this](const int &X, const int &Y) -> int {
+		if (X < 0 || X >= _width || Y < 0 || Y >= _height) {
+			return 0;
+		}
+
+		return _distanceField[X + Y * _width];
+	};
+
+	for (int y = Top; y <= Bottom; ++y) {
+		for (int x = Left; x <= Right; ++x) {
+			_distanceField[x + y * _width] = GetMapUnitTraits(GetMapUnitType(x + y * _width)).shape == RCMapUnitShape::None
+			                                 ? MaxEmptyDistance : 0;
+		}
+	}
+
+	// 切比雪夫距离变换：正向扫描传播左方与上方的距离，反向扫描传播右方与下方的距离
+	for (int y = Top; y <= Bottom; ++y) {
+		for (int x = Left; x <= Right; ++x) {
+			auto &value = _distanceField[x + y * _width];
+			const int nearest = std::min({distance(x - 1, y), distance(x - 1, y - 1), distance(x, y - 1), distance(x + 1, y - 1)});
+			value = static_cast<unsigned char>(std::min<int>(value, nearest + 1));
+		}
+	}
+	for (int y = Bottom; y >= Top; --y) {
+		for (int x = Right; x >= Left; --x) {
+			auto &value = _distanceField[x + y * _width];
+			const int nearest = std::min({distance(x + 1, y), distance(x + 1, y + 1), distance(x, y + 1), distance(x - 1, y + 1)});
+			value = static_cast<unsigned char>(std::min<int>(value, nearest + 1));
+		}
+	}
+}
+int RCMap::GetEmptyDistance(const int &Position) const {
+	return _distanceField[Position];
 }
 int RCMap::GetWidth() const {
 	return _width;
 }
 int RCMap::GetHeight() const {
 	return _height;
-}
\ No newline at end of file
+}
+RCMapRay::RCMapRay(const vecmath::Vector<float> &Position, const vecmath::Vector<float> &Direction)
+    : mapX(static_cast<int>(Position.x)), mapY(static_cast<int>(Position.y)), countX(0), countY(0),
+      deltaDistanceX(std::abs(1.f / Direction.x)), deltaDistanceY(std::abs(1.f / Direction.y)) {
+	if (Direction.x < 0) {
+		stepX   = -1;
+		originX = (Position.x - static_cast<float>(mapX)) * deltaDistanceX;
+	} else {
+		stepX   = 1;
+		originX = (static_cast<float>(mapX) + 1.f - Position.x) * deltaDistanceX;
+	}
+	if (Direction.y < 0) {
+		stepY   = -1;
+		originY = (Position.y - static_cast<float>(mapY)) * deltaDistanceY;
+	} else {
+		stepY   = 1;
+		originY = (static_cast<float>(mapY) + 1.f - Position.y) * deltaDistanceY;
+	}
+
+	sideDistanceX = originX;
+	sideDistanceY = originY;
+}
+void RCMapRay::Skip(const int &Radius) {
+	// 逐格步进时，X 方向第 i 次步进先于 Y 方向第 j 次步进当且仅当 SideDistanceX(i - 1) < SideDistanceY(j - 1)，
+	// 两个序列均单调不减，因此可以先求出哪个方向先离开区域，再求出另一个方向在此之前的步进次数：
+	// 先由除法估计次数，再逐次修正浮点误差，保证与逐格步进的比较结果一致
+	const float exitX = SideDistanceX(countX + Radius);
+	const float exitY = SideDistanceY(countY + Radius);
+
+	auto estimate = [&Radius](const float &Bound, const float &Origin, const float &Delta, const int &Count) -> int {
+		const float steps = (Bound - Origin) / Delta;
+		if (!(steps >= 0.f)) {
+			return 0;
+		}
+		if (steps >= static_cast<float>(Count + Radius)) {
+			return Radius;
+		}
+
+		return std::clamp(static_cast<int>(steps) - Count + 1, 0, Radius);
+	};
+
+	int stepCountX = Radius;
+	int stepCountY = Radius;
+	if (exitX < exitY) {
+		stepCountY = estimate(exitX, originY, deltaDistanceY, countY);
+		while (stepCountY > 0 && !(SideDistanceY(countY + stepCountY - 1) <= exitX)) {
+			--stepCountY;
+		}
+		while (stepCountY < Radius && SideDistanceY(countY + stepCountY) <= exitX) {
+			++stepCountY;
+		}
+	} else {
+		stepCountX = estimate(exitY, originX, deltaDistanceX, countX);
+		while (stepCountX > 0 && !(SideDistanceX(countX + stepCountX - 1) < exitY)) {
+			--stepCountX;
+		}
+		while (stepCountX < Radius && SideDistanceX(countX + stepCountX) < exitY) {
+			++stepCountX;
+		}
+	}
+
+	countX        += stepCountX;
+	countY        += stepCountY;
+	mapX          += stepX * stepCountX;
+	mapY          += stepY * stepCountY;
+	sideDistanceX  = SideDistanceX(countX);
+	sideDistanceY  = SideDistanceY(countY);
+}
+RCMapFixedRay::RCMapFixedRay(const int &PositionX, const int &PositionY, const int &DirectionX, const int &DirectionY,
+                             const long long &DeltaDistanceX, const long long &DeltaDistanceY)
+    : mapX(PositionX >> FractionBits), mapY(PositionY >> FractionBits), deltaDistanceX(DeltaDistanceX),
+      deltaDistanceY(DeltaDistanceY) {
+	// 起点到所在格子左上角的距离
+	const long long fractionX = PositionX & (One - 1);
+	const long long fractionY = PositionY & (One - 1);
+	if (DirectionX < 0) {
+		stepX         = -1;
+		sideDistanceX = (fractionX * deltaDistanceX) >> FractionBits;
+	} else {
+		stepX         = 1;
+		sideDistanceX = ((One - fractionX) * deltaDistanceX) >> FractionBits;
+	}
+	if (DirectionY < 0) {
+		stepY         = -1;
+		sideDistanceY = (fractionY * deltaDistanceY) >> FractionBits;
+	} else {
+		stepY         = 1;
+		sideDistanceY = ((One - fractionY) * deltaDistanceY) >> FractionBits;
+	}
+}
+void RCMapFixedRay::Skip(const int &Radius) {
+	// 与 RCMapRay::Skip 相同，先求出哪个方向先离开区域，再求出另一个方向在此之前的步进次数。
+	// 距离没有误差，X 方向第 i 次步进先于 Y 方向第 j 次步进当且仅当其前的距离满足严格小于，因此可以直接由除法求出
+	const long long exitX = sideDistanceX + Radius * deltaDistanceX;
+	const long long exitY = sideDistanceY + Radius * deltaDistanceY;
+
+	long long stepCountX = Radius;
+	long long stepCountY = Radius;
+	if (exitX < exitY) {
+		// 距离不超过 exitX 的 Y 方向网格线都先于 X 方向离开区域
+		stepCountY = exitX < sideDistanceY ? 0 : std::min<long long>((exitX - sideDistanceY) / deltaDistanceY + 1, Radius);
+	} else {
+		// 距离严格小于 exitY 的 X 方向网格线都先于 Y 方向离开区域
+		stepCountX = exitY <= sideDistanceX ? 0 : std::min<long long>((exitY - sideDistanceX - 1) / deltaDistanceX + 1, Radius);
+	}
+
+	mapX          += stepX * static_cast<int>(stepCountX);
+	mapY          += stepY * static_cast<int>(stepCountY);
+	sideDistanceX += stepCountX * deltaDistanceX;
+	sideDistanceY += stepCountY * deltaDistanceY;
+}
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2023~Now Margoo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/**
+ * \file RCProfiler.cpp
+ * \brief 按渲染阶段统计耗时的帧分析器
+ */
+
+#include <include/RCProfiler.h>
+#include <include/RCException.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+RCProfiler::RCProfiler(const int &Capacity) : _cursor(0), _count(0), _current{}, _currentRecorded(false) {
+	if (Capacity <= 0) {
+		throw RCInvalidParameterException("non-positive capacity", "RCProfiler construction");
+	}
+
+	_samples.resize(Capacity);
+}
+void RCProfiler::Record(const RCProfileStage &Stage, const double &Milliseconds) {
+	_current[static_cast<int>(Stage)] += Milliseconds;
+	_currentRecorded = true;
+}
+void RCProfiler::CommitFrame() {
+	if (!_currentRecorded) {
+		return;
+	}
+
+	_samples[_cursor] = _current;
+	_cursor           = (_cursor + 1) % static_cast<int>(_samples.size());
+	_count            = std::min(_count + 1, static_cast<int>(_samples.size()));
+	_current.fill(0);
+	_currentRecorded = false;
+}
+void RCProfiler::Clear() {
+	_cursor = 0;
+	_count  = 0;
+	_current.fill(0);
+	_currentRecorded = false;
+}
+void RCProfiler::SetCapacity(const int &Capacity) {
+	if (Capacity <= 0) {
+		throw RCInvalidParameterException("non-positive capacity", "RCProfiler.SetCapacity");
+	}
+
+	_samples.assign(Capacity, Sample{});
+	Clear();
+}
+int RCProfiler::GetFrameCount() const {
+	return _count;
+}
+std::vector<double> RCProfiler::CollectSamples(const RCProfileStage &Stage) const {
+	std::vector<double> result(_count);
+	// 环形缓冲区未写满时最旧的一帧位于开头，否则位于下一帧写入的位置
+	const int oldest = _count < static_cast<int>(_samples.size()) ? 0 : _cursor;
+	for (int count = 0; count < _count; ++count) {
+		result[count] = _samples[(oldest + count) % _samples.size()][static_cast<int>(Stage)];
+	}
+
+	return result;
+}
+double RCProfiler::GetPercentile(const RCProfileStage &Stage, const double &Percentile) const {
+	if (Percentile < 0 || Percentile > 100) {
+		throw RCInvalidParameterException("percentile out of range [0, 100]", "RCProfiler.GetPercentile");
+	}
+	if (_count == 0) {
+		return 0;
+	}
+
+	auto samples = CollectSamples(Stage);
+	// 最近秩法：第 ceil(P / 100 * N) 小的样本
+	const int rank = std::max(static_cast<int>(std::ceil(Percentile / 100.0 * _count)), 1) - 1;
+	std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+
+	return samples[rank];
+}
+RCProfileSummary RCProfiler::GetSummary(const RCProfileStage &Stage) const {
+	RCProfileSummary summary{};
+	if (_count == 0) {
+		return summary;
+	}
+
+	auto samples = CollectSamples(Stage);
+	std::sort(samples.begin(), samples.end());
+	auto rank = [&](const double &Percentile) {
+		return samples[std::max(static_cast<int>(std::ceil(Percentile / 100.0 * _count)), 1) - 1];
+	};
+	for (auto sample : samples) {
+		summary.average += sample;
+	}
+	summary.average /= static_cast<double>(_count);
+	summary.p50      = rank(50);
+	summary.p95      = rank(95);
+	summary.p99      = rank(99);
+	summary.max      = samples.back();
+
+	return summary;
+}
+void RCProfiler::WriteFramesCSV(std::ostream &Stream) const {
+	Stream << "index";
+	for (int stage = 0; stage < RCProfileStageCount; ++stage) {
+		Stream << ',' << GetStageName(static_cast<RCProfileStage>(stage));
+	}
+	Stream << '\n';
+
+	const int oldest = _count < static_cast<int>(_samples.size()) ? 0 : _cursor;
+	for (int count = 0; count < _count; ++count) {
+		const auto &sample = _samples[(oldest + count) % _samples.size()];
+		Stream << count;
+		for (auto time : sample) {
+			Stream << ',' << time;
+		}
+		Stream << '\n';
+	}
+}
+void RCProfiler::WriteSummaryCSV(std::ostream &Stream) const {
+	Stream << "stage,average,p50,p95,p99,max\n";
+	for (int stage = 0; stage < RCProfileStageCount; ++stage) {
+		const auto summary = GetSummary(static_cast<RCProfileStage>(stage));
+		Stream << GetStageName(static_cast<RCProfileStage>(stage)) << ',' << summary.average << ',' << summary.p50 << ','
+		       << summary.p95 << ',' << summary.p99 << ',' << summary.max << '\n';
+	}
+}
+void RCProfiler::DumpFramesCSV(const char *Path) const {
+	std::ofstream stream(Path);
+	if (!stream) {
+		throw RCCreationFailure("profiler CSV file");
+	}
+
+	WriteFramesCSV(stream);
+}
+void RCProfiler::DumpSummaryCSV(const char *Path) const {
+	std::ofstream stream(Path);
+	if (!stream) {
+		throw RCCreationFailure("profiler CSV file");
+	}
+
+	WriteSummaryCSV(stream);
+}
+const char *RCProfiler::GetStageName(const RCProfileStage &Stage) {
+	switch (Stage) {
+	case RCProfileStage::SkyCeiling:
+		return "sky_ceiling";
+	case RCProfileStage::Floor:
+		return "floor";
+	case RCProfileStage::WallTrace:
+		return "wall_trace";
+	case RCProfileStage::WallShading:
+		return "wall_shading";
+	case RCProfileStage::Sprites:
+		return "sprites";
+	case RCProfileStage::Upscale:
+		return "upscale";
+	case RCProfileStage::Flush:
+		return "flush";
+	case RCProfileStage::Frame:
+		return "frame";
+	}
+
+	return "unknown";
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2023~Now Margoo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/**
+ * \file RCRayPacket.cpp
+ * \brief 光线包内核的标量实现，以及运行时分发
+ */
+
+#include <include/RCRayPacket.h>
+
+namespace RCRender {
+	RayPacketKernel GetRayPacketKernel(const InstructionSet &Set) {
+		switch (Set) {
+			case InstructionSet::AVX2: {
+				return TraceRayPacketAVX2;
+			}
+			case InstructionSet::SSE41: {
+				return TraceRayPacketSSE41;
+			}
+			default: {
+				return TraceRayPacketScalar;
+			}
+		}
+	}
+	void TraceRayPacketScalar(const unsigned char *DistanceField, const int &MapWidth, RayPacket &Packet,
+	                          const int &Count) {
+		const vecmath::Vector<float> position(Packet.positionX, Packet.positionY, 0);
+		for (int lane = 0; lane < Count; ++lane) {
+			RCMapRay ray(position, vecmath::Vector<float>(Packet.directionX[lane], Packet.directionY[lane], 0));
+			bool     sideX;
+			TraceRayScalar(DistanceField, MapWidth, Packet.maxDistance, ray, sideX, Packet.steps[lane]);
+
+			Packet.mapX[lane]           = ray.mapX;
+			Packet.mapY[lane]           = ray.mapY;
+			Packet.stepX[lane]          = ray.stepX;
+			Packet.stepY[lane]          = ray.stepY;
+			Packet.countX[lane]         = ray.countX;
+			Packet.countY[lane]         = ray.countY;
+			Packet.originX[lane]        = ray.originX;
+			Packet.originY[lane]        = ray.originY;
+			Packet.deltaDistanceX[lane] = ray.deltaDistanceX;
+			Packet.deltaDistanceY[lane] = ray.deltaDistanceY;
+			Packet.sideDistanceX[lane]  = ray.sideDistanceX;
+			Packet.sideDistanceY[lane]  = ray.sideDistanceY;
+			Packet.sideX[lane]          = sideX;
+		}
+	}
+}
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2023~Now Margoo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/**
+ * \file RCRayPacketAVX2.cpp
+ * \brief 光线包内核的 AVX2 实现
+ *
+ * 该文件需要以对应的指令集编译（见 CMakeLists.txt）
+ */
+
+#include <include/RCRayPacket.h>
+
+#include <bit>
+#include <immintrin.h>
+
+namespace RCRender {
+	namespace {
+		// 尚未击中的光线不多于该数量时，同步步进已不再划算，剩余的光线逐条完成
+		constexpr int ScalarThreshold = 2;
+	}
+
+	void TraceRayPacketAVX2(const unsigned char *DistanceField, const int &MapWidth, RayPacket &Packet,
+	                        const int &Count) {
+		if (Count <= ScalarThreshold) {
+			TraceRayPacketScalar(DistanceField, MapWidth, Packet, Count);
+			return;
+		}
+
+		const auto    field    = reinterpret_cast<const int *>(DistanceField);
+		const __m256i zero     = _mm256_setzero_si256();
+		const __m256i one      = _mm256_set1_epi32(1);
+		const __m256i byteMask = _mm256_set1_epi32(0xFF);
+		const __m256i width    = _mm256_set1_epi32(MapWidth);
+		const __m256  limit    = _mm256_set1_ps(Packet.maxDistance);
+
+		// 与 RCMapRay 的构造函数相同，各条光线的起点相同，只有方向不同
+		const int     cellX      = static_cast<int>(Packet.positionX);
+		const int     cellY      = static_cast<int>(Packet.positionY);
+		const __m256  signMask   = _mm256_set1_ps(-0.f);
+		const __m256  directionX = _mm256_load_ps(Packet.directionX);
+		const __m256  directionY = _mm256_load_ps(Packet.directionY);
+		const __m256  negativeX  = _mm256_cmp_ps(directionX, _mm256_setzero_ps(), _CMP_LT_OQ);
+		const __m256  negativeY  = _mm256_cmp_ps(directionY, _mm256_setzero_ps(), _CMP_LT_OQ);
+		const __m256  deltaX     = _mm256_andnot_ps(signMask, _mm256_div_ps(_mm256_set1_ps(1.f), directionX));
+		const __m256  deltaY     = _mm256_andnot_ps(signMask, _mm256_div_ps(_mm256_set1_ps(1.f), directionY));
+		const __m256  originX    = _mm256_blendv_ps(
+		        _mm256_mul_ps(_mm256_set1_ps(static_cast<float>(cellX) + 1.f - Packet.positionX), deltaX),
+		        _mm256_mul_ps(_mm256_set1_ps(Packet.positionX - static_cast<float>(cellX)), deltaX), negativeX);
+		const __m256  originY    = _mm256_blendv_ps(
+		        _mm256_mul_ps(_mm256_set1_ps(static_cast<float>(cellY) + 1.f - Packet.positionY), deltaY),
+		        _mm256_mul_ps(_mm256_set1_ps(Packet.positionY - static_cast<float>(cellY)), deltaY), negativeY);
+		const __m256i stepX      = _mm256_blendv_epi8(one, _mm256_set1_epi32(-1), _mm256_castps_si256(negativeX));
+		const __m256i stepY      = _mm256_blendv_epi8(one, _mm256_set1_epi32(-1), _mm256_castps_si256(negativeY));
+		_mm256_store_si256(reinterpret_cast<__m256i *>(Packet.stepX), stepX);
+		_mm256_store_si256(reinterpret_cast<__m256i *>(Packet.stepY), stepY);
+		_mm256_store_ps(Packet.originX, originX);
+		_mm256_store_ps(Packet.originY, originY);
+		_mm256_store_ps(Packet.deltaDistanceX, deltaX);
+		_mm256_store_ps(Packet.deltaDistanceY, deltaY);
+
+		__m256i mapX          = _mm256_set1_epi32(cellX);
+		__m256i mapY          = _mm256_set1_epi32(cellY);
+		__m256i countX        = zero;
+		__m256i countY        = zero;
+		__m256  sideDistanceX = originX;
+		__m256  sideDistanceY = originY;
+		auto store = [&]() {
+			_mm256_store_si256(reinterpret_cast<__m256i *>(Packet.mapX), mapX);
+			_mm256_store_si256(reinterpret_cast<__m256i *>(Packet.mapY), mapY);
+			_mm256_store_si256(reinterpret_cast<__m256i *>(Packet.countX), countX);
+			_mm256_store_si256(reinterpret_cast<__m256i *>(Packet.countY), countY);
+			_mm256_store_ps(Packet.sideDistanceX, sideDistanceX);
+			_mm256_store_ps(Packet.sideDistanceY, sideDistanceY);
+		};
+		auto load = [&]() {
+			mapX          = _mm256_load_si256(reinterpret_cast<const __m256i *>(Packet.mapX));
+			mapY          = _mm256_load_si256(reinterpret_cast<const __m256i *>(Packet.mapY));
+			countX        = _mm256_load_si256(reinterpret_cast<const __m256i *>(Packet.countX));
+			countY        = _mm256_load_si256(reinterpret_cast<const __m256i *>(Packet.countY));
+			sideDistanceX = _mm256_load_ps(Packet.sideDistanceX);
+			sideDistanceY = _mm256_load_ps(Packet.sideDistanceY);
+		};
+
+		// 未击中的光线的掩码，以及各光线最后一次是否沿 X 方向步进与步进的次数
+		__m256i active = _mm256_cmpgt_epi32(_mm256_set1_epi32(Count), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+		__m256i sideX  = zero;
+		__m256i steps  = zero;
+		// 距离场按字节存放，以 1 为比例收集 32 位后只保留最低字节，已击中的光线不再读取
+		auto gather = [&]() {
+			const __m256i position = _mm256_add_epi32(mapX, _mm256_mullo_epi32(mapY, width));
+			return _mm256_and_si256(_mm256_mask_i32gather_epi32(zero, field, position, active, 1), byteMask);
+		};
+
+		__m256i distance   = gather();
+		int     activeMask = _mm256_movemask_ps(_mm256_castsi256_ps(active));
+		while (true) {
+			// 跳过空旷区域所需的步数因光线而异，交由 RCMapRay::Skip 逐条完成
+			const int skipMask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_and_si256(active, _mm256_cmpgt_epi32(distance, one))));
+			if (skipMask != 0) {
+				alignas(32) int distances[MaxRayPacketSize];
+				_mm256_store_si256(reinterpret_cast<__m256i *>(distances), distance);
+				store();
+				for (int lane = 0; lane < MaxRayPacketSize; ++lane) {
+					if (skipMask & (1 << lane)) {
+						auto ray = Packet.GetRay(lane);
+						ray.Skip(distances[lane] - 1);
+						Packet.SetRay(lane, ray);
+					}
+				}
+				load();
+			}
+
+			// 与 RCMapRay::Step 相同，sideDistanceX < sideDistanceY 时沿 X 方向步进，否则沿 Y 方向步进
+			const __m256i alongX = _mm256_and_si256(active, _mm256_castps_si256(_mm256_cmp_ps(sideDistanceX, sideDistanceY, _CMP_LT_OQ)));
+			const __m256i alongY = _mm256_andnot_si256(alongX, active);
+
+			// 掩码为 -1，减去掩码即为加一；步进后的次数至少为 1，距离总是 origin + count * delta
+			countX        = _mm256_sub_epi32(countX, alongX);
+			countY        = _mm256_sub_epi32(countY, alongY);
+			mapX          = _mm256_add_epi32(mapX, _mm256_and_si256(stepX, alongX));
+			mapY          = _mm256_add_epi32(mapY, _mm256_and_si256(stepY, alongY));
+			sideDistanceX = _mm256_blendv_ps(sideDistanceX, _mm256_add_ps(originX, _mm256_mul_ps(_mm256_cvtepi32_ps(countX), deltaX)),
+			                                 _mm256_castsi256_ps(alongX));
+			sideDistanceY = _mm256_blendv_ps(sideDistanceY, _mm256_add_ps(originY, _mm256_mul_ps(_mm256_cvtepi32_ps(countY), deltaY)),
+			                                 _mm256_castsi256_ps(alongY));
+			sideX         = _mm256_blendv_epi8(sideX, alongX, active);
+			steps         = _mm256_sub_epi32(steps, active);
+
+			// 与 RCMapRay::IsBeyond 相同，越过最大距离的光线亦停止步进
+			const __m256 beyond = _mm256_or_ps(_mm256_cmp_ps(_mm256_sub_ps(sideDistanceX, deltaX), limit, _CMP_GE_OQ),
+			                                   _mm256_cmp_ps(_mm256_sub_ps(sideDistanceY, deltaY), limit, _CMP_GE_OQ));
+			distance   = gather();
+			active     = _mm256_andnot_si256(_mm256_cmpeq_epi32(distance, zero), active);
+			active     = _mm256_andnot_si256(_mm256_castps_si256(beyond), active);
+			activeMask = _mm256_movemask_ps(_mm256_castsi256_ps(active));
+			if (std::popcount(static_cast<unsigned>(activeMask)) <= ScalarThreshold) {
+				break;
+			}
+		}
+
+		store();
+		_mm256_store_si256(reinterpret_cast<__m256i *>(Packet.sideX), sideX);
+		_mm256_store_si256(reinterpret_cast<__m256i *>(Packet.steps), steps);
+		for (int lane = 0; lane < Count; ++lane) {
+			if (activeMask & (1 << lane)) {
+				// 光线已在空气中步进过，继续逐条步进即可
+				auto ray = Packet.GetRay(lane);
+				bool side;
+				int  remain;
+				TraceRayScalar(DistanceField, MapWidth, Packet.maxDistance, ray, side, remain);
+				Packet.SetRay(lane, ray);
+				Packet.sideX[lane]  = side;
+				Packet.steps[lane] += remain;
+			}
+		}
+	}
+}
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2023~Now Margoo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/**
+ * \file RCRayPacketSSE41.cpp
+ * \brief 光线包内核的 SSE4.1 实现
+ *
+ * 该文件需要以对应的指令集编译（见 CMakeLists.txt）
+ */
+
+#include <include/RCRayPacket.h>
+
+#include <algorithm>
+#include <bit>
+#include <smmintrin.h>
+
+namespace RCRender {
+	namespace {
+		// 每次同步步进的光线数
+		constexpr int LaneCount = 4;
+		// 尚未击中的光线不多于该数量时，同步步进已不再划算，剩余的光线逐条完成
+		constexpr int ScalarThreshold = 1;
+
+		/**
+		 * 让光线包中从 Base 开始的 Count 条光线（不超过 4 条）同步步进
+		 */
+		void TraceRayPacket4(const unsigned char *DistanceField, const int &MapWidth, RayPacket &Packet, const int &Base,
+		                     const int &Count) {
+			const __m128i zero  = _mm_setzero_si128();
+			const __m128i one   = _mm_set1_epi32(1);
+			const __m128i width = _mm_set1_epi32(MapWidth);
+			const __m128  limit = _mm_set1_ps(Packet.maxDistance);
+
+			// 与 RCMapRay 的构造函数相同，各条光线的起点相同，只有方向不同
+			const int     cellX      = static_cast<int>(Packet.positionX);
+			const int     cellY      = static_cast<int>(Packet.positionY);
+			const __m128  signMask   = _mm_set1_ps(-0.f);
+			const __m128  directionX = _mm_load_ps(Packet.directionX + Base);
+			const __m128  directionY = _mm_load_ps(Packet.directionY + Base);
+			const __m128  negativeX  = _mm_cmplt_ps(directionX, _mm_setzero_ps());
+			const __m128  negativeY  = _mm_cmplt_ps(directionY, _mm_setzero_ps());
+			const __m128  deltaX     = _mm_andnot_ps(signMask, _mm_div_ps(_mm_set1_ps(1.f), directionX));
+			const __m128  deltaY     = _mm_andnot_ps(signMask, _mm_div_ps(_mm_set1_ps(1.f), directionY));
+			const __m128  originX    = _mm_blendv_ps(_mm_mul_ps(_mm_set1_ps(static_cast<float>(cellX) + 1.f - Packet.positionX), deltaX),
+			                                         _mm_mul_ps(_mm_set1_ps(Packet.positionX - static_cast<float>(cellX)), deltaX), negativeX);
+			const __m128  originY    = _mm_blendv_ps(_mm_mul_ps(_mm_set1_ps(static_cast<float>(cellY) + 1.f - Packet.positionY), deltaY),
+			                                         _mm_mul_ps(_mm_set1_ps(Packet.positionY - static_cast<float>(cellY)), deltaY), negativeY);
+			const __m128i stepX      = _mm_blendv_epi8(one, _mm_set1_epi32(-1), _mm_castps_si128(negativeX));
+			const __m128i stepY      = _mm_blendv_epi8(one, _mm_set1_epi32(-1), _mm_castps_si128(negativeY));
+			_mm_store_si128(reinterpret_cast<__m128i *>(Packet.stepX + Base), stepX);
+			_mm_store_si128(reinterpret_cast<__m128i *>(Packet.stepY + Base), stepY);
+			_mm_store_ps(Packet.originX + Base, originX);
+			_mm_store_ps(Packet.originY + Base, originY);
+			_mm_store_ps(Packet.deltaDistanceX + Base, deltaX);
+			_mm_store_ps(Packet.deltaDistanceY + Base, deltaY);
+
+			__m128i mapX          = _mm_set1_epi32(cellX);
+			__m128i mapY          = _mm_set1_epi32(cellY);
+			__m128i countX        = zero;
+			__m128i countY        = zero;
+			__m128  sideDistanceX = originX;
+			__m128  sideDistanceY = originY;
+			auto store = [&]() {
+				_mm_store_si128(reinterpret_cast<__m128i *>(Packet.mapX + Base), mapX);
+				_mm_store_si128(reinterpret_cast<__m128i *>(Packet.mapY + Base), mapY);
+				_mm_store_si128(reinterpret_cast<__m128i *>(Packet.countX + Base), countX);
+				_mm_store_si128(reinterpret_cast<__m128i *>(Packet.countY + Base), countY);
+				_mm_store_ps(Packet.sideDistanceX + Base, sideDistanceX);
+				_mm_store_ps(Packet.sideDistanceY + Base, sideDistanceY);
+			};
+			auto load = [&]() {
+				mapX          = _mm_load_si128(reinterpret_cast<const __m128i *>(Packet.mapX + Base));
+				mapY          = _mm_load_si128(reinterpret_cast<const __m128i *>(Packet.mapY + Base));
+				countX        = _mm_load_si128(reinterpret_cast<const __m128i *>(Packet.countX + Base));
+				countY        = _mm_load_si128(reinterpret_cast<const __m128i *>(Packet.countY + Base));
+				sideDistanceX = _mm_load_ps(Packet.sideDistanceX + Base);
+				sideDistanceY = _mm_load_ps(Packet.sideDistanceY + Base);
+			};
+
+			// 未击中的光线的掩码，以及各光线最后一次是否沿 X 方向步进与步进的次数
+			__m128i active     = _mm_cmpgt_epi32(_mm_set1_epi32(Count), _mm_setr_epi32(0, 1, 2, 3));
+			int     activeMask = _mm_movemask_ps(_mm_castsi128_ps(active));
+			__m128i sideX      = zero;
+			__m128i steps      = zero;
+			// SSE 没有 gather 指令，逐条读取尚未击中的光线所在单位的距离
+			auto gather = [&]() {
+				alignas(16) int position[LaneCount];
+				_mm_store_si128(reinterpret_cast<__m128i *>(position), _mm_add_epi32(mapX, _mm_mullo_epi32(mapY, width)));
+				return _mm_setr_epi32(activeMask & 1 ? DistanceField[position[0]] : 0,
+				                      activeMask & 2 ? DistanceField[position[1]] : 0,
+				                      activeMask & 4 ? DistanceField[position[2]] : 0,
+				                      activeMask & 8 ? DistanceField[position[3]] : 0);
+			};
+
+			__m128i distance = gather();
+			while (true) {
+				// 跳过空旷区域所需的步数因光线而异，交由 RCMapRay::Skip 逐条完成
+				const int skipMask = _mm_movemask_ps(_mm_castsi128_ps(_mm_and_si128(active, _mm_cmpgt_epi32(distance, one))));
+				if (skipMask != 0) {
+					alignas(16) int distances[LaneCount];
+					_mm_store_si128(reinterpret_cast<__m128i *>(distances), distance);
+					store();
+					for (int lane = 0; lane < LaneCount; ++lane) {
+						if (skipMask & (1 << lane)) {
+							auto ray = Packet.GetRay(Base + lane);
+							ray.Skip(distances[lane] - 1);
+							Packet.SetRay(Base + lane, ray);
+						}
+					}
+					load();
+				}
+
+				// 与 RCMapRay::Step 相同，sideDistanceX < sideDistanceY 时沿 X 方向步进，否则沿 Y 方向步进
+				const __m128i alongX = _mm_and_si128(active, _mm_castps_si128(_mm_cmplt_ps(sideDistanceX, sideDistanceY)));
+				const __m128i alongY = _mm_andnot_si128(alongX, active);
+
+				// 掩码为 -1，减去掩码即为加一；步进后的次数至少为 1，距离总是 origin + count * delta
+				countX        = _mm_sub_epi32(countX, alongX);
+				countY        = _mm_sub_epi32(countY, alongY);
+				mapX          = _mm_add_epi32(mapX, _mm_and_si128(stepX, alongX));
+				mapY          = _mm_add_epi32(mapY, _mm_and_si128(stepY, alongY));
+				sideDistanceX = _mm_blendv_ps(sideDistanceX, _mm_add_ps(originX, _mm_mul_ps(_mm_cvtepi32_ps(countX), deltaX)),
+				                              _mm_castsi128_ps(alongX));
+				sideDistanceY = _mm_blendv_ps(sideDistanceY, _mm_add_ps(originY, _mm_mul_ps(_mm_cvtepi32_ps(countY), deltaY)),
+				                              _mm_castsi128_ps(alongY));
+				sideX         = _mm_blendv_epi8(sideX, alongX, active);
+				steps         = _mm_sub_epi32(steps, active);
+
+				// 与 RCMapRay::IsBeyond 相同，越过最大距离的光线亦停止步进
+				const __m128 beyond = _mm_or_ps(_mm_cmpge_ps(_mm_sub_ps(sideDistanceX, deltaX), limit),
+				                                _mm_cmpge_ps(_mm_sub_ps(sideDistanceY, deltaY), limit));
+				distance   = gather();
+				active     = _mm_andnot_si128(_mm_cmpeq_epi32(distance, zero), active);
+				active     = _mm_andnot_si128(_mm_castps_si128(beyond), active);
+				activeMask = _mm_movemask_ps(_mm_castsi128_ps(active));
+				if (std::popcount(static_cast<unsigned>(activeMask)) <= ScalarThreshold) {
+					break;
+				}
+			}
+
+			store();
+			_mm_store_si128(reinterpret_cast<__m128i *>(Packet.sideX + Base), sideX);
+			_mm_store_si128(reinterpret_cast<__m128i *>(Packet.steps + Base), steps);
+			for (int lane = 0; lane < Count; ++lane) {
+				if (activeMask & (1 << lane)) {
+					// 光线已在空气中步进过，继续逐条步进即可
+					auto ray = Packet.GetRay(Base + lane);
+					bool side;
+					int  remain;
+					TraceRayScalar(DistanceField, MapWidth, Packet.maxDistance, ray, side, remain);
+					Packet.SetRay(Base + lane, ray);
+					Packet.sideX[Base + lane]  = side;
+					Packet.steps[Base + lane] += remain;
+				}
+			}
+		}
+	}
+
+	void TraceRayPacketSSE41(const unsigned char *DistanceField, const int &MapWidth, RayPacket &Packet,
+	                         const int &Count) {
+		for (int base = 0; base < Count; base += LaneCount) {
+			TraceRayPacket4(DistanceField, MapWidth, Packet, base, std::min(LaneCount, Count - base));
+		}
+	}
+}
@@ -27,13 +27,15 @@
 
 #include <include/RCRenderTarget.h>
 
+#include <cstring>
+
 RCRenderTarget::RCRenderTarget(RCContext *Context) {
 	if (Context == nullptr) {
 		throw RCInvalidParameterException("nullptr", "RCRenderTarget construction");
 	}
 
 	_context    = Context;
-	_backBuffer = GetImageBuffer(_context->_context);
+	_backBuffer = _context->GetBuffer();
 }
 RCColor RCRenderTarget::ReadPixel(const int &X, const int &Y) {
 	return RCColor::MakeFromCOLORREF(_backBuffer[_context->GetWidth() * Y + X]);
@@ -47,15 +49,16 @@ RCColor RCRenderTarget::ReadPixel(const int &Position) {
 void RCRenderTarget::WritePixel(const int &Position, const RCColor &Color) {
 	_backBuffer[Position] = Color.ToCOLORREF();
 }
+RCContext* RCRenderTarget::GetContext() {
+	return _context;
+}
+#ifdef _RC_BACKEND_EASYX_
 void RCRenderTarget::Select() {
 	SetWorkingImage(_context->_context);
 }
 IMAGE* RCRenderTarget::GetImage() {
 	return _context->_context;
 }
-RCContext* RCRenderTarget::GetContext() {
-	return _context;
-}
 void RCRenderTarget::Flush() {
 	if (_context->_context == nullptr) {
 		FlushBatchDraw();
@@ -66,4 +69,33 @@ void RCRenderTarget::Clear() {
 	SetWorkingImage(_context->_context);
 	cleardevice();
 	SetWorkingImage(cache);
-}
\ No newline at end of file
+}
+void RCRenderTarget::StretchBlit(RCRenderTarget *Source, const int &Width, const int &Height,
+                                 const int &SourceWidth, const int &SourceHeight) {
+	StretchBlt(GetImageHDC(_context->_context), 0, 0, Width, Height, GetImageHDC(Source->_context->_context),
+	           0, 0, SourceWidth, SourceHeight, SRCCOPY);
+}
+#else
+void RCRenderTarget::Flush() {
+	// 无头后端没有需要提交的窗口
+}
+void RCRenderTarget::Clear() {
+	memset(_backBuffer, 0, sizeof(DWORD) * _context->GetWidth() * _context->GetHeight());
+}
+void RCRenderTarget::StretchBlit(RCRenderTarget *Source, const int &Width, const int &Height,
+                                 const int &SourceWidth, const int &SourceHeight) {
+	const int targetStride = _context->GetWidth();
+	const int sourceStride = Source->_context->GetWidth();
+	// 使用 16.16 定点数进行步进，避免逐像素的除法
+	const int stepX = (SourceWidth << 16) / Width;
+	const int stepY = (SourceHeight << 16) / Height;
+
+	for (int y = 0, sourceY = 0; y < Height; ++y, sourceY += stepY) {
+		auto sourceLine = Source->_backBuffer + (sourceY >> 16) * sourceStride;
+		auto targetLine = _backBuffer + y * targetStride;
+		for (int x = 0, sourceX = 0; x < Width; ++x, sourceX += stepX) {
+			targetLine[x] = sourceLine[sourceX >> 16];
+		}
+	}
+}
+#endif
\ No newline at end of file
@@ -26,36 +26,303 @@
  */
 
 #include <include/RCRenderer.h>
+#include <include/RCTrace.h>
 
 #include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <limits>
+#include <unordered_set>
+
+namespace {
+	/**
+	 * 从 Start 到现在经过的时间（毫秒）
+	 */
+	double ElapsedMilliseconds(const std::chrono::steady_clock::time_point &Start) {
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count();
+	}
+
+	/**
+	 * 将作用域的耗时与计数器的增量累加到线程上下文中的某一渲染阶段
+	 */
+	class StageScope {
+	public:
+		StageScope(RCRender::ThreadContext &Context, const RCProfileStage &Stage, RCProfileCounters *Counters)
+		    : _context(Context), _stage(static_cast<int>(Stage)), _counters(Counters), _start{} {
+			if (_counters != nullptr) {
+				_counters->Read(_start.data());
+			}
+			_startTime = std::chrono::steady_clock::now();
+		}
+		~StageScope() {
+			_context.stageTime[_stage] += ElapsedMilliseconds(_startTime);
+			if (_counters != nullptr) {
+				std::array<long long, RCProfileCounters::MaxCounterCount> end{};
+				_counters->Read(end.data());
+				for (int count = 0; count < _counters->GetCounterCount(); ++count) {
+					_context.stageCounters[_stage][count] += end[count] - _start[count];
+				}
+			}
+		}
+
+		StageScope(const StageScope &)            = delete;
+		StageScope &operator=(const StageScope &) = delete;
+
+	private:
+		RCRender::ThreadContext                                   &_context;
+		int                                                        _stage;
+		RCProfileCounters                                         *_counters;
+		std::array<long long, RCProfileCounters::MaxCounterCount> _start;
+		std::chrono::steady_clock::time_point                      _startTime;
+	};
+
+	/**
+	 * 求交时光线的起点与方向，浮点数光线与定点数光线的距离表示不同，
+	 * 半格距离、斜墙交点与纹理坐标的计算分别由下面的特化给出
+	 */
+	template <class Ray>
+	struct RayGeometry;
+
+	template <>
+	struct RayGeometry<RCMapRay> {
+		using Distance = float;
+
+		[[nodiscard]] static float HalfDelta(const float &Delta) {
+			return Delta * 0.5f;
+		}
+		[[nodiscard]] static float ToFloat(const float &Value) {
+			return Value;
+		}
+		/**
+		 * 求光线与格子对角线的交点
+		 * @return 若交点位于格子内则返回 true，否则返回 false
+		 */
+		bool IntersectDiagonal(const RCMapRay &Ray, const int &Slope, float &PerpDistance, float &WallX) const {
+			float k = static_cast<float>(Slope);
+			float distance;
+			if (Slope > 0) {
+				distance = positionX - Ray.mapX - positionY + Ray.mapY;
+				if (direction.y != direction.x) {
+					PerpDistance = (Ray.mapY + k * (positionX - Ray.mapX) - positionY) / (direction.y - k * direction.x);
+					WallX        = (positionX + direction.x * PerpDistance - Ray.mapX);
+				} else {
+					WallX        = -1;
+					PerpDistance = -1;
+				}
+			}
+			else {
+				distance = Ray.mapX - positionX - positionY + Ray.mapY + 1;
+				if (direction.y != direction.x) {
+					PerpDistance = (Ray.mapY + 1.f + k * (positionX - Ray.mapX) - positionY) / (direction.y - k * direction.x);
+					WallX        = positionX + direction.x * PerpDistance - Ray.mapX;
+				} else {
+					WallX        = -1;
+					PerpDistance = -1;
+				}
+			}
+
+			if (WallX < 0.f || WallX >= 1.f) {
+				return false;
+			}
+
+			if (distance < 0) {
+				WallX = 1.f - WallX;
+			}
+
+			return true;
+		}
+		/**
+		 * 求光线击中格子的 NS 或 EW 面时的纹理坐标
+		 */
+		[[nodiscard]] float GetWallX(const float &PerpDistance, const RCRender::HideSide &HitSide) const {
+			float wallX;
+			if (HitSide == RCRender::HideSide::NS) {
+				wallX = positionY + PerpDistance * direction.y;
+			} else {
+				wallX = positionX + PerpDistance * direction.x;
+			}
+			wallX -= floor(wallX);
+
+			return wallX;
+		}
+
+		float                  positionX;
+		float                  positionY;
+		vecmath::Vector<float> direction;
+	};
+
+	template <>
+	struct RayGeometry<RCMapFixedRay> {
+		using Distance = long long;
+
+		[[nodiscard]] static long long HalfDelta(const long long &Delta) {
+			return Delta >> 1;
+		}
+		[[nodiscard]] static float ToFloat(const long long &Value) {
+			return RCMapFixedRay::ToFloat(Value);
+		}
+		/**
+		 * 求光线与格子对角线的交点，对角线为 y - cellY = ±(x - cellX) (+ 1)
+		 * @return 若交点位于格子内则返回 true，否则返回 false
+		 */
+		bool IntersectDiagonal(const RCMapFixedRay &Ray, const int &Slope, long long &PerpDistance,
+		                       long long &WallX) const {
+			constexpr long long one   = RCMapFixedRay::One;
+			constexpr int       bits  = RCMapFixedRay::FractionBits;
+			const long long     cellX = static_cast<long long>(Ray.mapX) << bits;
+			const long long     cellY = static_cast<long long>(Ray.mapY) << bits;
+			long long numerator;
+			long long denominator;
+			long long distance;
+			if (Slope > 0) {
+				numerator   = cellY + (positionX - cellX) - positionY;
+				denominator = directionY - directionX;
+				distance    = positionX - cellX - positionY + cellY;
+			} else {
+				numerator   = cellY + one - (positionX - cellX) - positionY;
+				denominator = directionY + directionX;
+				distance    = cellX - positionX - positionY + cellY + one;
+			}
+			if (denominator == 0) {
+				return false;
+			}
+			PerpDistance = std::clamp((numerator << bits) / denominator, -RCMapFixedRay::MaxDeltaDistance,
+			                          RCMapFixedRay::MaxDeltaDistance);
+			WallX        = positionX + ((directionX * PerpDistance) >> bits) - cellX;
+			if (WallX < 0 || WallX >= one) {
+				return false;
+			}
+			if (distance < 0) {
+				WallX = one - WallX;
+			}
+
+			return true;
+		}
+		/**
+		 * 求光线击中格子的 NS 或 EW 面时的纹理坐标
+		 */
+		[[nodiscard]] long long GetWallX(const long long &PerpDistance, const RCRender::HideSide &HitSide) const {
+			constexpr long long one  = RCMapFixedRay::One;
+			constexpr int       bits = RCMapFixedRay::FractionBits;
+			if (HitSide == RCRender::HideSide::NS) {
+				return (positionY + ((PerpDistance * directionY) >> bits)) & (one - 1);
+			}
+
+			return (positionX + ((PerpDistance * directionX) >> bits)) & (one - 1);
+		}
+
+		int positionX;
+		int positionY;
+		int directionX;
+		int directionY;
+	};
+
+	/**
+	 * 求光线与所在格子中物体的交点，浮点数与定点数光线的步进规则相同，只有距离的表示不同
+	 * @param Geometry 光线的起点与方向
+	 * @param MapRay 停在该格子上的光线
+	 * @param MapUnit 格子中的单位
+	 * @param HitSide 光线进入该格子时穿过的面
+	 * @param Object 击中的物体
+	 * @return 若光线击中了该单位则返回 true，若光线从单位旁穿过则返回 false
+	 */
+	template <class Ray>
+	bool ClassifyHit(const RayGeometry<Ray> &Geometry, const Ray &MapRay, const RCMapUnit &MapUnit,
+	                 RCRender::HideSide HitSide, RCRender::MapObject &Object) {
+		using Distance = typename RayGeometry<Ray>::Distance;
+
+		const auto &traits = GetMapUnitTraits(MapUnit.Type);
+		Distance    perpDistance;
+		Distance    wallX;
+		switch (traits.shape) {
+			case RCMapUnitShape::Thin: {
+				if (HitSide == RCRender::HideSide::NS) {
+					perpDistance = MapRay.sideDistanceX - Geometry.HalfDelta(MapRay.deltaDistanceX);
+					if (MapRay.sideDistanceY < perpDistance) {
+						return false;
+					}
+				} else {
+					perpDistance = MapRay.sideDistanceY - Geometry.HalfDelta(MapRay.deltaDistanceY);
+					if (MapRay.sideDistanceX < perpDistance) {
+						return false;
+					}
+				}
+				break;
+			}
+			case RCMapUnitShape::Diagonal: {
+				if (!Geometry.IntersectDiagonal(MapRay, traits.slope, perpDistance, wallX)) {
+					return false;
+				}
+
+				HitSide = RCRender::HideSide::DIG;
+				break;
+			}
+			default: {
+				if (HitSide == RCRender::HideSide::NS) {
+					perpDistance = MapRay.sideDistanceX - MapRay.deltaDistanceX;
+				} else {
+					perpDistance = MapRay.sideDistanceY - MapRay.deltaDistanceY;
+				}
+				break;
+			}
+		}
+		// 斜墙在求交时已得到纹理坐标
+		if (HitSide != RCRender::HideSide::DIG) {
+			wallX = Geometry.GetWallX(perpDistance, HitSide);
+		}
+
+		Object.sideDistanceX  = Geometry.ToFloat(MapRay.sideDistanceX);
+		Object.sideDistanceY  = Geometry.ToFloat(MapRay.sideDistanceY);
+		Object.perpDistance   = Geometry.ToFloat(perpDistance);
+		Object.deltaDistanceX = Geometry.ToFloat(MapRay.deltaDistanceX);
+		Object.deltaDistanceY = Geometry.ToFloat(MapRay.deltaDistanceY);
+		Object.unit           = MapUnit;
+		Object.hitSide        = HitSide;
+		Object.mapX           = MapRay.mapX;
+		Object.mapY           = MapRay.mapY;
+		Object.wallX          = Geometry.ToFloat(wallX);
+
+		return true;
+	}
+}
 
 RCRenderer::RCRenderer(RCRenderTarget *RenderTarget, RCCamera *Camera, RCScene *Scene)
     : _renderTarget(RenderTarget), _camera(Camera), _scene(Scene),
-      _enableResolution(false) {
+      _enableResolution(false), _threadPool(nullptr),
+      _spriteList(nullptr), _spriteCount(0), _spriteColumnOffset(nullptr), _spriteColumnIndex(nullptr),
+      _columnDepth(nullptr), _columnHitOffset(nullptr), _columnHitCount(nullptr),
+      _columnCoverStart(nullptr), _columnCoverEnd(nullptr), _enableOverdrawCulling(false), _enableMipmap(false),
+      _wallPassTime(0), _renderScale(1.f),
+      _minimumRenderScale(0.5f), _maximumRenderScale(1.f), _renderScaleStep(0.125f), _targetFrameTime(0), _frameTime(0),
+      _frameTimeHistory{}, _frameTimeCursor(0), _frameTimeCount(0), _enableFrameReuse(false), _frameValid(false),
+      _frameUpdate(RCRender::FrameUpdate::Full), _updatedColumns(0), _tracedRays(0), _traceSteps(0), _frameCamera{},
+      _frameScene(nullptr), _frameSceneVersion(0), _frameMapVersion(0),
+      _profileCounters(nullptr), _stageCounters{} {
 	if (_renderTarget == nullptr || _camera == nullptr || _scene == nullptr) {
 		throw RCInvalidParameterException("nullptr", "RCRenderer construction");
 	}
 
+	SetThreadCount(1);
+
+	// 依据 CPU 支持的指令集选择地板与天花板的行扫描内核
+	for (unsigned features = 0; features < RCRender::FloorFeature::Count; ++features) {
+		_floorSpanKernels[features] = RCRender::GetFloorSpanKernel(RCRender::DetectInstructionSet(), features);
+	}
+	_rayPacketKernel = RCRender::GetRayPacketKernel(RCRender::DetectInstructionSet());
+	_upscaleKernel   = RCRender::GetUpscaleKernel(RCRender::UpscaleFilter::Nearest, RCRender::DetectInstructionSet());
+
 	_renderTargetWidth  = _renderTarget->GetContext()->GetWidth();
 	_renderTargetHeight = _renderTarget->GetContext()->GetHeight();
 
-	_fogColorR = GetRValue(_scene->_fogColor);
-	_fogColorG = GetGValue(_scene->_fogColor);
-	_fogColorB = GetBValue(_scene->_fogColor);
-
 	_contextResolution      = new RCContext(RenderTarget->_context->GetWidth() / 2, RenderTarget->_context->GetHeight() / 2);
 	_resolutionRenderTarget = new RCRenderTarget(_contextResolution);
-	_resolutionDC           = GetImageHDC(_contextResolution->_context);
-	_renderTargetDC         = GetImageHDC(RenderTarget->GetImage());
 
 	_resolutionWidth  = _renderTargetWidth / 2;
 	_resolutionHeight = _renderTargetHeight / 2;
 
 	PitchMax = _renderTargetHeight / 4.f;
 
-	_renderTargetDC = GetImageHDC(_renderTarget->GetImage());
-	_resolutionDC   = GetImageHDC(_resolutionRenderTarget->GetImage());
-
 #ifdef _RC_RENDER_DEBUGER_
 	// 初始化调试器字体
 	gettextstyle(&_debuggerFont);
@@ -69,19 +336,154 @@ RCRenderer::RCRenderer(RCRenderTarget *RenderTarget, RCCamera *Camera, RCScene *
 	setbkmode(TRANSPARENT);
 #endif
 }
+RCRenderer::~RCRenderer() {
+	delete _threadPool;
+	for (auto context : _threadContexts) {
+		delete context;
+	}
+
+	delete _resolutionRenderTarget;
+	delete _contextResolution;
+}
+void RCRenderer::SetThreadCount(const int &Count) {
+	if (Count <= 0) {
+		throw RCInvalidParameterException("non-positive thread count", "RCRenderer.SetThreadCount");
+	}
+
+	delete _threadPool;
+	_threadPool = new RCThreadPool(Count);
+
+	while (_threadContexts.size() < static_cast<size_t>(Count)) {
+		_threadContexts.push_back(new RCRender::ThreadContext);
+	}
+	while (_threadContexts.size() > static_cast<size_t>(Count)) {
+		delete _threadContexts.back();
+		_threadContexts.pop_back();
+	}
+}
+int RCRenderer::GetThreadCount() const {
+	return _threadPool->GetThreadCount();
+}
 void RCRenderer::EnableSuperResolution(const bool &Status) {
-	_enableResolution = Status;
+	ApplyRenderScale(Status ? 0.5f : 1.f);
+}
+void RCRenderer::SetRenderScale(const float &Scale) {
+	if (Scale <= 0.f || Scale > 1.f) {
+		throw RCInvalidParameterException("render scale out of range", "RCRenderer.SetRenderScale");
+	}
+
+	ApplyRenderScale(Scale);
+}
+float RCRenderer::GetRenderScale() const {
+	return _renderScale;
+}
+void RCRenderer::SetTargetFrameTime(const double &Milliseconds) {
+	if (Milliseconds < 0) {
+		throw RCInvalidParameterException("negative frame time", "RCRenderer.SetTargetFrameTime");
+	}
+
+	_targetFrameTime = Milliseconds;
+	_frameTimeCount  = 0;
+}
+void RCRenderer::SetDynamicResolutionRange(const float &MinimumScale, const float &MaximumScale, const float &Step) {
+	if (MinimumScale <= 0.f || MinimumScale > MaximumScale || MaximumScale > 1.f || Step <= 0.f) {
+		throw RCInvalidParameterException("invalid dynamic resolution range", "RCRenderer.SetDynamicResolutionRange");
+	}
+
+	_minimumRenderScale = MinimumScale;
+	_maximumRenderScale = MaximumScale;
+	_renderScaleStep    = Step;
+	_frameTimeCount     = 0;
+}
+void RCRenderer::SetUpscaleFilter(const RCRender::UpscaleFilter &Filter) {
+	_upscaleKernel = RCRender::GetUpscaleKernel(Filter, RCRender::DetectInstructionSet());
+	_frameValid    = false;
+}
+void RCRenderer::EnableFrameReuse(const bool &Status) {
+	_enableFrameReuse = Status;
+	_frameValid       = false;
+}
+void RCRenderer::InvalidateFrame() {
+	_frameValid = false;
+}
+void RCRenderer::ApplyRenderScale(const float &Scale) {
+	_renderScale = Scale;
+	_frameValid  = false;
+
+	const int width  = _renderTarget->_context->GetWidth();
+	const int height = _renderTarget->_context->GetHeight();
+	_resolutionWidth  = std::max(1, static_cast<int>(static_cast<float>(width) * Scale));
+	_resolutionHeight = std::max(1, static_cast<int>(static_cast<float>(height) * Scale));
+
+	_enableResolution = _resolutionWidth != width || _resolutionHeight != height;
 	if (_enableResolution) {
+		if (_contextResolution->GetWidth() != _resolutionWidth || _contextResolution->GetHeight() != _resolutionHeight) {
+			// 调整大小后画布的像素缓冲区会重新分配
+			_contextResolution->Resize(_resolutionWidth, _resolutionHeight);
+			_resolutionRenderTarget->_backBuffer = _contextResolution->GetBuffer();
+		}
+
 		_renderTargetWidth  = _resolutionWidth;
 		_renderTargetHeight = _resolutionHeight;
 	}
 	else {
-		_renderTargetWidth  = _renderTarget->_context->GetWidth();
-		_renderTargetHeight = _renderTarget->_context->GetHeight();
+		_renderTargetWidth  = width;
+		_renderTargetHeight = height;
 	}
 
 	PitchMax = _renderTargetHeight / 4.f;
 }
+void RCRenderer::UpdateDynamicResolution(const double &FrameTime) {
+	const int historySize = static_cast<int>(_frameTimeHistory.size());
+	_frameTimeHistory[_frameTimeCursor] = FrameTime;
+	_frameTimeCursor = (_frameTimeCursor + 1) % historySize;
+	_frameTimeCount  = std::min(_frameTimeCount + 1, historySize);
+	if (_frameTimeCount < historySize) {
+		return;
+	}
+
+	double averageTime = 0;
+	for (auto time : _frameTimeHistory) {
+		averageTime += time;
+	}
+	averageTime /= static_cast<double>(historySize);
+
+	// 渲染的像素数与渲染缩放比例的平方成正比
+	float scale = _renderScale;
+	if (averageTime > _targetFrameTime) {
+		// 按比例估计刚好满足目标帧时间的缩放比例，并至少降低一级
+		scale = std::min(_renderScale - _renderScaleStep,
+		                 _renderScale * static_cast<float>(std::sqrt(_targetFrameTime / averageTime)));
+	}
+	else {
+		// 每次只提高一级，且只有预计提高后仍不超出目标帧时间时才提高，以免在两级之间来回振荡
+		const float ratio = (_renderScale + _renderScaleStep) / _renderScale;
+		if (averageTime * ratio * ratio < _targetFrameTime) {
+			scale = _renderScale + _renderScaleStep;
+		}
+	}
+
+	// 向下对齐到 MinimumScale + k * Step，额外的偏移用于吸收浮点误差
+	scale = _minimumRenderScale +
+	        std::floor((scale - _minimumRenderScale) / _renderScaleStep + 1e-3f) * _renderScaleStep;
+	scale = std::clamp(scale, _minimumRenderScale, _maximumRenderScale);
+	if (scale != _renderScale) {
+		ApplyRenderScale(scale);
+		_frameTimeCount = 0;
+	}
+}
+void RCRenderer::EnableOverdrawCulling(const bool &Status) {
+	_enableOverdrawCulling = Status;
+}
+void RCRenderer::EnableMipmap(const bool &Status) {
+	_enableMipmap = Status;
+	_frameValid   = false;
+}
+void RCRenderer::EnableRayPackets(const bool &Status) {
+	// 求交结果与逐列步进一致，无需重新渲染
+	_rayPacketKernel = RCRender::GetRayPacketKernel(Status ? RCRender::DetectInstructionSet()
+	                                                       : RCRender::InstructionSet::Scalar);
+}
 void RCRenderer::SetScene(RCScene *Scene) {
 	if (Scene == nullptr) {
 		throw RCInvalidParameterException("nullptr", "RCRenderer.SetScene");
@@ -90,42 +492,37 @@ void RCRenderer::SetScene(RCScene *Scene) {
 		throw RCInvalidParameterException("Invalid RCScene object", "RCRenderer construction");
 	}
 
-	_scene     = Scene;
-	_fogColorR = GetRValue(_scene->_fogColor);
-	_fogColorG = GetGValue(_scene->_fogColor);
-	_fogColorB = GetBValue(_scene->_fogColor);
+	_scene = Scene;
 }
 float RCRenderer::Render() {
-	_renderTarget->Clear();
-
-	time_t frameStart = clock();
-
-	const auto pitch       = _camera->_pitch * PitchMax;
-	const auto fogConstant = (_scene->_map->GetWidth() + _scene->_map->GetHeight()) / 2;
-	vecmath::Vector<float> rayRightDirection = _camera->Direction - _camera->Plane;
-	vecmath::Vector<float> rayLeftDirection  = _camera->Direction + _camera->Plane;
-
-	float cameraZFloor = 0.5f * _renderTargetHeight + _camera->Z;
-	float cameraZCeiling = 0.5f * _renderTargetHeight - _camera->Z;
-
-	// 如果启用天空盒，则渲染天空盒
-	if (_scene->_enableSkybox) {
-		RenderSkyBox(_renderTargetWidth, _renderTargetHeight, pitch, fogConstant, rayRightDirection, rayLeftDirection, 0);
-	} else {
-		// 否则渲染天花板
-		RenderCeiling(_renderTargetWidth, _renderTargetHeight, pitch, fogConstant, rayRightDirection, rayLeftDirection, cameraZCeiling, 0);
+	RC_TRACE_SCOPE("Render", "render");
+
+	// 每一帧都会写入画布上的所有像素，因此无需先清空画布
+	auto frameTimeStart = std::chrono::steady_clock::now();
+	// 上一帧的样本包含调用者在 Render 之后计时的阶段，在此时才完整
+	_profiler.CommitFrame();
+
+	// 启用画面复用时，与上一帧的状态比较，决定重新渲染整帧、部分列或直接沿用上一帧
+	_frameUpdate    = _enableFrameReuse ? CheckFrameUpdate() : RCRender::FrameUpdate::Full;
+	_updatedColumns = 0;
+	_tracedRays     = 0;
+	_traceSteps     = 0;
+	_stageCounters  = {};
+	if (_frameUpdate != RCRender::FrameUpdate::Reused) {
+		RenderFrame();
+		RecordThreadStages();
 	}
-	// 渲染地板
-	RenderFloor(_renderTargetWidth, _renderTargetHeight, pitch, fogConstant, rayRightDirection, rayLeftDirection, cameraZFloor, 0);
-	// 渲染墙体
-	RayCasting(_renderTargetWidth, _renderTargetHeight, pitch, fogConstant, rayRightDirection, rayLeftDirection, 0);
-
-	if (_enableResolution) {
-		StretchBlt(_renderTargetDC, 0, 0, _renderTargetWidth * 2, _renderTargetHeight * 2, _resolutionDC,
-		           0, 0, _renderTargetWidth, _renderTargetHeight, SRCCOPY);
+	if (_frameUpdate == RCRender::FrameUpdate::Reused) {
+		_wallPassTime = 0;
 	}
+	_frameValid = _enableFrameReuse;
 
-	auto logicalFrame = static_cast<float>(clock() - frameStart) / 1000.f;
+	_frameTime = ElapsedMilliseconds(frameTimeStart);
+	_profiler.Record(RCProfileStage::Frame, _frameTime);
+	// 沿用或只重新渲染部分列的帧无法反映当前分辨率下的开销
+	if (_targetFrameTime > 0 && _frameUpdate == RCRender::FrameUpdate::Full) {
+		UpdateDynamicResolution(_frameTime);
+	}
 
 #ifdef _RC_RENDER_DEBUGER_
 	OutDebugText();
@@ -137,118 +534,468 @@ float RCRenderer::Render() {
 		_oldClock = clock();
 	}
 
+#endif
+
+	auto logicalFrame = static_cast<float>(ElapsedMilliseconds(frameTimeStart) / 1000.0);
+#ifdef _RC_RENDER_DEBUGER_
 	outtextxy(50, 150, std::format(_T("Logical frame : {}"), logicalFrame).c_str());
 #endif
 
 	return logicalFrame < 0.001f ? 0.001f : logicalFrame;
 }
-void RCRenderer::RenderFloor(const int &Width, const int &Height, const float &Pitch, const int& FogConstant,
-                             const vecmath::Vector<float>& RayRightDirection, const vecmath::Vector<float>& RayLeftDirection,
-                             const float& CameraZ, const int &Start) {
-	const auto textureWidth  = _scene->_floorTexture->_context->GetWidth();
-	const auto textureHeight = _scene->_floorTexture->_context->GetHeight();
+void RCRenderer::RenderFrame() {
+	const auto pitch       = _camera->_pitch * PitchMax;
+	vecmath::Vector<float> rayRightDirection = _camera->Direction - _camera->Plane;
+	vecmath::Vector<float> rayLeftDirection  = _camera->Direction + _camera->Plane;
 
-	auto bufferPointer = _enableResolution ? _resolutionRenderTarget->_backBuffer : _renderTarget->_backBuffer;
+	float cameraZFloor = 0.5f * _renderTargetHeight + _camera->Z;
+	float cameraZCeiling = 0.5f * _renderTargetHeight - _camera->Z;
 
-	// 渲染地板
-	for (int y = Height / 2 + Pitch + 1, relative = 1; y < Height; ++y, ++relative) {
-		auto verticalPosition = y * Width;
+	// 回收上一帧的临时内存
+	_frameArena.Reset();
+	for (auto context : _threadContexts) {
+		context->frameArena.Reset();
+		context->stageTime.fill(0);
+		context->stageCounters = {};
+	}
 
-		float floorDistance  = CameraZ / static_cast<float>(relative);
+	{
+		RC_TRACE_SCOPE("PrepareSprites", "render");
+		StageScope stage(*_threadContexts[0], RCProfileStage::Sprites, _profileCounters);
+		PrepareSprites(pitch);
+	}
 
-		vecmath::Vector<float> floorStep    = floorDistance * (RayLeftDirection - RayRightDirection) / static_cast<float>(Width);
-		vecmath::Vector<float> realPosition = _camera->Position + floorDistance * RayRightDirection;
+	_columnHitOffset  = _frameArena.Allocate<int>(_renderTargetWidth);
+	_columnHitCount   = _frameArena.Allocate<int>(_renderTargetWidth);
+	_columnCoverStart = _frameArena.Allocate<int>(_renderTargetWidth);
+	_columnCoverEnd   = _frameArena.Allocate<int>(_renderTargetWidth);
+	if (_scene->_enableFixedPointTraversal) {
+		UpdateFixedColumns();
+	}
 
-		float fog = 0;
-		if (_scene->_enableFog) {
-			// 越远烟雾越浓
-			fog = floorDistance / static_cast<float>(FogConstant) * _scene->_fogLevel;
+	const int threadCount = _threadPool->GetThreadCount();
+	auto traceColumns = [&](const int &Index) {
+		const int columnStart = _renderTargetWidth * Index / threadCount;
+		const int columnEnd   = _renderTargetWidth * (Index + 1) / threadCount;
+
+		RC_TRACE_SCOPE("TraceColumns", "render");
+		StageScope stage(*_threadContexts[Index], RCProfileStage::WallTrace, _profileCounters);
+		if (_scene->_enableFixedPointTraversal) {
+			TraceColumnsFixed(_renderTargetWidth, _renderTargetHeight, pitch, columnStart, columnEnd,
+			                  *_threadContexts[Index]);
+		} else {
+			TraceColumns(_renderTargetWidth, _renderTargetHeight, pitch, columnStart, columnEnd, *_threadContexts[Index]);
 		}
+	};
+	// 每个线程求交的列同时也是它渲染墙体的列，只需渲染其中需要重新渲染的部分
+	auto forEachColumns = [&](const int &Index, auto &&Function) {
+		const int bandStart = _renderTargetWidth * Index / threadCount;
+		const int bandEnd   = _renderTargetWidth * (Index + 1) / threadCount;
+		for (const auto &range : _columnRanges) {
+			const int columnStart = std::max(range.start, bandStart);
+			const int columnEnd   = std::min(range.end, bandEnd);
+			if (columnEnd > columnStart) {
+				Function(columnStart, columnEnd);
+			}
+		}
+	};
+	// 天空盒与墙体按列分块，地板与天花板按行分块；天空盒与地板覆盖的行互不相交，
+	// 而同一行的天花板与地板总是由同一线程先后渲染，因此背景的渲染无需同步
+	auto renderBackground = [&](const int &Index) {
+		const int rowStart    = _renderTargetHeight * Index / threadCount;
+		const int rowEnd      = _renderTargetHeight * (Index + 1) / threadCount;
+		auto     &context     = *_threadContexts[Index];
+
+		for (const auto &range : _columnRanges) {
+			if (!_scene->_enableSkybox) {
+				// 如果未启用天空盒，则渲染天花板
+				RC_TRACE_SCOPE("RenderCeiling", "render");
+				StageScope stage(context, RCProfileStage::SkyCeiling, _profileCounters);
+				RenderCeiling(_renderTargetWidth, _renderTargetHeight, pitch, rayRightDirection, rayLeftDirection,
+				              cameraZCeiling, rowStart, rowEnd, range.start, range.end);
+			}
+			// 渲染地板
+			RC_TRACE_SCOPE("RenderFloor", "render");
+			StageScope stage(context, RCProfileStage::Floor, _profileCounters);
+			RenderFloor(_renderTargetWidth, _renderTargetHeight, pitch, rayRightDirection, rayLeftDirection,
+			            cameraZFloor, rowStart, rowEnd, range.start, range.end);
+		}
+		// 如果启用天空盒，则渲染天空盒
+		if (_scene->_enableSkybox) {
+			RC_TRACE_SCOPE("RenderSkyBox", "render");
+			StageScope stage(context, RCProfileStage::SkyCeiling, _profileCounters);
+			forEachColumns(Index, [&](const int &ColumnStart, const int &ColumnEnd) {
+				RenderSkyBox(_renderTargetWidth, _renderTargetHeight, pitch, rayRightDirection, rayLeftDirection,
+				             ColumnStart, ColumnEnd);
+			});
+		}
+	};
+	// 各阶段在调用线程上的区间包含等待其它线程完成的时间
+	if (_frameUpdate == RCRender::FrameUpdate::Partial) {
+		// 需要先求交，才能得知哪些列击中了状态改变的门
+		{
+			RC_TRACE_SCOPE("TracePass", "render");
+			_threadPool->Dispatch(traceColumns);
+		}
+		CollectDirtyColumns();
+		if (_columnRanges.empty()) {
+			// 改变的精灵在上一帧与本帧都不可见
+			_frameUpdate = RCRender::FrameUpdate::Reused;
+			RecordSpriteColumns();
 
-		for (int x = 0; x < Width; ++x) {
-			vecmath::Vector<int>    texture(textureWidth, textureHeight, 0);
-			float cellX = static_cast<int>(realPosition.x);
-			float cellY = static_cast<int>(realPosition.y);
-			int textureX = static_cast<int>(texture.x * (realPosition.x - cellX)) & (textureWidth - 1);
-			int textureY = static_cast<int>(texture.y * (realPosition.y - cellY)) & (textureHeight - 1);
+			return;
+		}
+		RC_TRACE_SCOPE("BackgroundPass", "render");
+		_threadPool->Dispatch(renderBackground);
+	} else {
+		_columnRanges.assign(1, RCRender::ColumnRange{ 0, _renderTargetWidth });
+		if (_enableOverdrawCulling) {
+			// 背景只渲染墙体之间的空隙，因此需要先求出所有列被墙体覆盖的行
+			{
+				RC_TRACE_SCOPE("TracePass", "render");
+				_threadPool->Dispatch(traceColumns);
+			}
+			RC_TRACE_SCOPE("BackgroundPass", "render");
+			_threadPool->Dispatch(renderBackground);
+		} else {
+			// 求交不会写入画布，可以与背景在同一阶段完成
+			RC_TRACE_SCOPE("TraceBackgroundPass", "render");
+			_threadPool->Dispatch([&](const int &Index) {
+				traceColumns(Index);
+				renderBackground(Index);
+			});
+		}
+	}
+	if (_enableFrameReuse) {
+		RecordSpriteColumns();
+	}
+	for (const auto &range : _columnRanges) {
+		_updatedColumns += range.end - range.start;
+	}
 
-			realPosition += floorStep;
+	// 墙体会覆盖其它线程渲染的地板与天花板，因此需要等待背景全部完成
+	auto wallPassStart = std::chrono::steady_clock::now();
+	{
+		RC_TRACE_SCOPE("WallPass", "render");
+		_threadPool->Dispatch([&](const int &Index) {
+			RC_TRACE_SCOPE("WallShading", "render");
+			StageScope stage(*_threadContexts[Index], RCProfileStage::WallShading, _profileCounters);
+			forEachColumns(Index, [&](const int &ColumnStart, const int &ColumnEnd) {
+				// 渲染墙体
+				RayCasting(_renderTargetWidth, _renderTargetHeight, pitch, rayRightDirection, rayLeftDirection,
+				           ColumnStart, ColumnEnd, *_threadContexts[Index]);
+			});
+		});
+	}
+	_wallPassTime = ElapsedMilliseconds(wallPassStart);
 
-			auto textureColor = _scene->_floorTexture->_buffer[textureWidth * textureY + textureX];
-			// 如果启用了烟雾，则计算烟雾效果
-			if (_scene->_enableFog) {
-				if (fog >= 1) {
-					textureColor = _scene->_fogColor;
-				} else if (fog > 0) {
-					auto r = GetRValue(textureColor) * (1 - fog) + _fogColorR * fog;
-					auto g = GetGValue(textureColor) * (1 - fog) + _fogColorG * fog;
-					auto b = GetBValue(textureColor) * (1 - fog) + _fogColorB * fog;
+	if (_enableResolution) {
+		// 在引擎内放大画面，而非调用 GDI，放大同样按行分块交由各线程完成
+		const int targetWidth  = _renderTarget->_context->GetWidth();
+		const int targetHeight = _renderTarget->_context->GetHeight();
+		RC_TRACE_SCOPE("UpscalePass", "render");
+		_threadPool->Dispatch([&](const int &Index) {
+			RC_TRACE_SCOPE("Upscale", "render");
+			StageScope stage(*_threadContexts[Index], RCProfileStage::Upscale, _profileCounters);
+			_upscaleKernel(_resolutionRenderTarget->_backBuffer, _renderTargetWidth, _renderTargetWidth, _renderTargetHeight,
+			               _renderTarget->_backBuffer, targetWidth, targetWidth, targetHeight,
+			               targetHeight * Index / threadCount, targetHeight * (Index + 1) / threadCount);
+		});
+	}
+}
+void RCRenderer::RecordThreadStages() {
+	// 各线程同时渲染，阶段对帧时间的贡献取决于耗时最长的线程，而计数器则反映所有线程的工作量
+	const int counterCount = _profileCounters != nullptr ? _profileCounters->GetCounterCount() : 0;
+	for (auto stage : { RCProfileStage::SkyCeiling, RCProfileStage::Floor, RCProfileStage::WallTrace,
+	                    RCProfileStage::WallShading, RCProfileStage::Sprites, RCProfileStage::Upscale }) {
+		const int index   = static_cast<int>(stage);
+		double    longest = 0;
+		for (auto context : _threadContexts) {
+			longest = std::max(longest, context->stageTime[index]);
+			for (int count = 0; count < counterCount; ++count) {
+				_stageCounters[index][count] += context->stageCounters[index][count];
+			}
+		}
+		if (stage != RCProfileStage::Upscale || _enableResolution) {
+			_profiler.Record(stage, longest);
+		}
+	}
+	// 每一列都会求交，即使只重新渲染部分列
+	_tracedRays = _renderTargetWidth;
+	for (auto context : _threadContexts) {
+		_traceSteps += context->traceSteps;
+	}
+}
+RCRender::FrameUpdate RCRenderer::CheckFrameUpdate() {
+	RC_TRACE_SCOPE("CheckFrameUpdate", "render");
+
+	const RCRender::CameraState camera{ _camera->Position.x, _camera->Position.y, _camera->Direction.x,
+	                                    _camera->Direction.y, _camera->Plane.x, _camera->Plane.y, _camera->Z,
+	                                    _camera->_pitch };
+	const auto map = _scene->_map;
+
+	// 相机、场景设置或地图改变时，所有列都可能改变
+	bool valid = _frameValid && _frameScene == _scene && _frameSceneVersion == _scene->_version &&
+	             _frameMapVersion == map->_version && _frameCamera == camera &&
+	             _frameDoors.size() == map->_doorTable.size() &&
+	             _frameSprites.size() == static_cast<size_t>(_scene->SpriteCount);
+
+	_frameCamera       = camera;
+	_frameScene        = _scene;
+	_frameSceneVersion = _scene->_version;
+	_frameMapVersion   = map->_version;
+
+	// 门与精灵逐个比较，状态改变的门与精灵只影响其所在的列。地图未改变时门表的遍历顺序不变
+	_changedDoors.clear();
+	_changedSprites.clear();
+	_frameDoors.resize(map->_doorTable.size());
+	_frameSprites.resize(_scene->SpriteCount);
+
+	size_t door = 0;
+	for (const auto &[position, mapDoor] : map->_doorTable) {
+		const RCRender::DoorState state{ position, mapDoor, mapDoor->Offset, mapDoor->Max };
+		if (!(_frameDoors[door] == state)) {
+			_changedDoors.push_back(position);
+			_frameDoors[door] = state;
+		}
+		++door;
+	}
+	for (int count = 0; count < _scene->SpriteCount; ++count) {
+		const auto                  sprite = _scene->SpriteList[count];
+		const RCRender::SpriteState state{ sprite, sprite->texture, sprite->x, sprite->y, sprite->z };
+		if (!(_frameSprites[count] == state)) {
+			_changedSprites.push_back(count);
+			_frameSprites[count] = state;
+		}
+	}
 
-					textureColor = RGB(r, g, b);
+	if (!valid) {
+		return RCRender::FrameUpdate::Full;
+	}
+	if (_changedDoors.empty() && _changedSprites.empty()) {
+		return RCRender::FrameUpdate::Reused;
+	}
+
+	return RCRender::FrameUpdate::Partial;
+}
+void RCRenderer::CollectDirtyColumns() {
+	RC_TRACE_SCOPE("CollectDirtyColumns", "render");
+
+	auto dirty = _frameArena.Allocate<BYTE>(_renderTargetWidth);
+	std::fill(dirty, dirty + _renderTargetWidth, 0);
+
+	// 门的开合不影响光线能否到达门所在的单位，因此受门影响的列就是击中了门的列
+	if (!_changedDoors.empty()) {
+		const int threadCount = _threadPool->GetThreadCount();
+		const int mapWidth    = _scene->_map->_width;
+		for (int index = 0; index < threadCount; ++index) {
+			const auto context = _threadContexts[index];
+			for (int x = _renderTargetWidth * index / threadCount; x < _renderTargetWidth * (index + 1) / threadCount; ++x) {
+				const auto objects = context->hitList + _columnHitOffset[x];
+				for (int hit = 0; hit < _columnHitCount[x] && dirty[x] == 0; ++hit) {
+					const int position = objects[hit].mapX + objects[hit].mapY * mapWidth;
+					if (std::find(_changedDoors.begin(), _changedDoors.end(), position) != _changedDoors.end()) {
+						dirty[x] = 1;
+					}
 				}
 			}
+		}
+	}
 
-			textureColor                                = (textureColor >> 1) & 8355711;
-			bufferPointer[verticalPosition + x]   = textureColor;
+	// 精灵改变时，其在上一帧与本帧覆盖的列都需要重新渲染
+	for (auto index : _changedSprites) {
+		const auto &range = _frameSpriteColumns[index];
+		std::fill(dirty + range.start, dirty + range.end, 1);
+	}
+	for (int count = 0; count < _spriteCount; ++count) {
+		const auto &sprite = _spriteList[count];
+		if (std::find(_changedSprites.begin(), _changedSprites.end(), sprite.index) != _changedSprites.end()) {
+			std::fill(dirty + sprite.drawStartX, dirty + sprite.drawEndX, 1);
+		}
+	}
+
+	_columnRanges.clear();
+	for (int x = 0; x < _renderTargetWidth;) {
+		while (x < _renderTargetWidth && dirty[x] == 0) {
+			++x;
+		}
+		const int start = x;
+		while (x < _renderTargetWidth && dirty[x] != 0) {
+			++x;
+		}
+		if (x > start) {
+			_columnRanges.push_back(RCRender::ColumnRange{ start, x });
 		}
 	}
 }
-void RCRenderer::RenderCeiling(const int &Width, const int &Height, const float &Pitch,
-                               const int &FogConstant, const vecmath::Vector<float> &RayRightDirection,
-                               const vecmath::Vector<float> &RayLeftDirection,
-                               const float &CameraZ,
-                               const int &Start) {
-	const auto textureWidth  = _scene->_ceilingTexture->_context->GetWidth();
-	const auto textureHeight = _scene->_ceilingTexture->_context->GetHeight();
+void RCRenderer::RecordSpriteColumns() {
+	_frameSpriteColumns.assign(_scene->SpriteCount, RCRender::ColumnRange{ 0, 0 });
+	for (int count = 0; count < _spriteCount; ++count) {
+		_frameSpriteColumns[_spriteList[count].index] = RCRender::ColumnRange{ _spriteList[count].drawStartX,
+		                                                                       _spriteList[count].drawEndX };
+	}
+}
+RCProfiler &RCRenderer::GetProfiler() {
+	return _profiler;
+}
+void RCRenderer::SetProfileCounters(RCProfileCounters *Counters) {
+	_profileCounters = Counters;
+}
+const RCProfileCounterValues &RCRenderer::GetStageCounters() const {
+	return _stageCounters;
+}
+RCRender::Statistics RCRenderer::GetStatistics() const {
+	RCRender::Statistics statistics{};
+	statistics.wallPassTime   = _wallPassTime;
+	statistics.frameTime      = _frameTime;
+	statistics.renderScale    = _renderScale;
+	statistics.frameUpdate    = _frameUpdate;
+	statistics.updatedColumns = _updatedColumns;
+	statistics.tracedRays     = _tracedRays;
+	statistics.traceSteps     = _traceSteps;
+
+	// 同一纹理可能同时被多个地图单位与精灵使用，只统计一次
+	std::unordered_set<const RCTexture *> textures;
+	for (auto texture : _scene->_map->_textureTable) {
+		if (texture != nullptr) {
+			textures.insert(texture);
+		}
+	}
+	for (int count = 0; count < _scene->SpriteCount; ++count) {
+		textures.insert(_scene->SpriteList[count]->texture);
+	}
+	for (auto texture : textures) {
+		statistics.columnMajorTextureSize += texture->GetColumnMajorSize();
+	}
 
+	return statistics;
+}
+void RCRenderer::RenderFloor(const int &Width, const int &Height, const float &Pitch,
+                             const vecmath::Vector<float>& RayRightDirection, const vecmath::Vector<float>& RayLeftDirection,
+                             const float& CameraZ, const int &Start, const int &End, const int &ColumnStart,
+                             const int &ColumnEnd) {
 	auto bufferPointer = _enableResolution ? _resolutionRenderTarget->_backBuffer : _renderTarget->_backBuffer;
 
+	RCRender::FloorSpan span{};
+	// 是否启用烟雾只影响内核的选择，逐行决定
+	const auto kernel    = _floorSpanKernels[0];
+	const auto fogKernel = _floorSpanKernels[RCRender::FloorFeature::Fog];
+
+	// 烟雾达到最高等级的行直接以烟雾颜色填充
+	const BYTE *saturatedColormap = _scene->GetSaturatedFogColormap();
+	span.fogColor = RGB(saturatedColormap[0], saturatedColormap[256], saturatedColormap[512]);
+
+	const int floorStart = static_cast<int>(Height / 2 + Pitch + 1);
+	const int rowStart   = std::max(Start, floorStart);
+	const int rowEnd     = std::min(End, Height);
+
 	// 渲染地板
-	for (int y = Height / 2 + Pitch + 1, relative = 1; y >= 0; --y, ++relative) {
-		auto verticalPosition = y * Width;
-		float floorDistance   = CameraZ / static_cast<float>(relative);
+	for (int y = rowStart, relative = rowStart - floorStart + 1; y < rowEnd; ++y, ++relative) {
+		float floorDistance  = CameraZ / static_cast<float>(relative);
 
 		vecmath::Vector<float> floorStep    = floorDistance * (RayLeftDirection - RayRightDirection) / static_cast<float>(Width);
 		vecmath::Vector<float> realPosition = _camera->Position + floorDistance * RayRightDirection;
 
-		float fog = 0;
-		if (_scene->_enableFog) {
-			// 越远烟雾越浓
-			fog = floorDistance / static_cast<float>(FogConstant) * _scene->_fogLevel;
+		// 越远烟雾越浓
+		span.colormap  = _scene->_enableFog ? _scene->GetFogColormap(floorDistance) : nullptr;
+		span.saturated = span.colormap == saturatedColormap;
+
+		// 相邻两行之间的距离差为 floorDistance / relative，与横向步长中较大者决定 mipmap 层级，
+		// 完全被烟雾覆盖的行不读取纹理
+		if (!span.saturated) {
+			SelectFloorMipLevel(_scene->_floorTexture, std::max({ std::abs(floorStep.x), std::abs(floorStep.y),
+			                                                      floorDistance / static_cast<float>(relative) }), span);
 		}
 
-		for (int x = 0; x < Width; ++x) {
-			vecmath::Vector<int> texture(textureWidth, textureHeight, 0);
-			float cellX  = static_cast<int>(realPosition.x) - realPosition.x;
-			float cellY  = static_cast<int>(realPosition.y) - realPosition.y;
-			int textureX = static_cast<int>(texture.x * cellX) & (textureWidth - 1);
-			int textureY = static_cast<int>(texture.y * cellY) & (textureHeight - 1);
+		span.positionX = realPosition.x;
+		span.positionY = realPosition.y;
+		span.stepX     = floorStep.x;
+		span.stepY     = floorStep.y;
+		span.output    = bufferPointer + y * Width;
+		RenderFloorSpans(span.colormap != nullptr ? fogKernel : kernel, span, y, ColumnStart, ColumnEnd);
+	}
+}
+void RCRenderer::RenderCeiling(const int &Width, const int &Height, const float &Pitch,
+                               const vecmath::Vector<float> &RayRightDirection,
+                               const vecmath::Vector<float> &RayLeftDirection,
+                               const float &CameraZ,
+                               const int &Start, const int &End, const int &ColumnStart, const int &ColumnEnd) {
+	auto bufferPointer = _enableResolution ? _resolutionRenderTarget->_backBuffer : _renderTarget->_backBuffer;
 
-			realPosition += floorStep;
+	RCRender::FloorSpan span{};
+	const auto kernel    = _floorSpanKernels[RCRender::FloorFeature::Ceiling];
+	const auto fogKernel = _floorSpanKernels[RCRender::FloorFeature::Ceiling | RCRender::FloorFeature::Fog];
 
-			auto textureColor = _scene->_ceilingTexture->_buffer[textureWidth * textureY + textureX];
-			// 如果启用了烟雾，则计算烟雾效果
-			if (_scene->_enableFog) {
-				if (fog >= 1) {
-					textureColor = _scene->_fogColor;
-				} else if (fog > 0) {
-					auto r = GetRValue(textureColor) * (1 - fog) + _fogColorR * fog;
-					auto g = GetGValue(textureColor) * (1 - fog) + _fogColorG * fog;
-					auto b = GetBValue(textureColor) * (1 - fog) + _fogColorB * fog;
+	// 烟雾达到最高等级的行直接以烟雾颜色填充
+	const BYTE *saturatedColormap = _scene->GetSaturatedFogColormap();
+	span.fogColor = RGB(saturatedColormap[0], saturatedColormap[256], saturatedColormap[512]);
 
-					textureColor = RGB(r, g, b);
-				}
-			}
+	const int ceilingStart = static_cast<int>(Height / 2 + Pitch + 1);
+	const int rowStart     = std::min(End - 1, ceilingStart);
+	const int rowEnd       = std::max(Start, 0);
+
+	// 渲染天花板
+	for (int y = rowStart, relative = ceilingStart - rowStart + 1; y >= rowEnd; --y, ++relative) {
+		float floorDistance = CameraZ / static_cast<float>(relative);
+
+		vecmath::Vector<float> floorStep    = floorDistance * (RayLeftDirection - RayRightDirection) / static_cast<float>(Width);
+		vecmath::Vector<float> realPosition = _camera->Position + floorDistance * RayRightDirection;
+
+		// 越远烟雾越浓
+		span.colormap  = _scene->_enableFog ? _scene->GetFogColormap(floorDistance) : nullptr;
+		span.saturated = span.colormap == saturatedColormap;
+
+		if (!span.saturated) {
+			SelectFloorMipLevel(_scene->_ceilingTexture, std::max({ std::abs(floorStep.x), std::abs(floorStep.y),
+			                                                        floorDistance / static_cast<float>(relative) }), span);
+		}
+
+		span.positionX = realPosition.x;
+		span.positionY = realPosition.y;
+		span.stepX     = floorStep.x;
+		span.stepY     = floorStep.y;
+		span.output    = bufferPointer + y * Width;
+		RenderFloorSpans(span.colormap != nullptr ? fogKernel : kernel, span, y, ColumnStart, ColumnEnd);
+	}
+}
+void RCRenderer::SelectFloorMipLevel(RCTexture *Texture, const float &Footprint, RCRender::FloorSpan &Span) const {
+	const int mipLevel = _enableMipmap ? Texture->SelectMipLevel(
+		Footprint * static_cast<float>(std::max(Texture->_context->GetWidth(), Texture->_context->GetHeight()))) : 0;
+	const auto &mip    = Texture->_mipLevels[mipLevel];
+
+	Span.texture       = mip.buffer;
+	Span.textureWidth  = mip.width;
+	Span.textureHeight = mip.height;
+}
+void RCRenderer::RenderFloorSpans(const RCRender::FloorSpanKernel &Kernel, RCRender::FloorSpan &Span, const int &Y,
+                                  const int &Start, const int &End) {
+	if (!_enableOverdrawCulling) {
+		Span.begin = Start;
+		Span.end   = End;
+		Kernel(Span);
+
+		return;
+	}
 
-			// 使颜色略黑
-			textureColor                                     = (textureColor >> 1) & 8355711;
-			bufferPointer[verticalPosition + x] = textureColor;
+	// 只渲染这一行中未被墙体覆盖的连续区间
+	int x = Start;
+	while (x < End) {
+		while (x < End && _columnCoverStart[x] <= Y && Y <= _columnCoverEnd[x]) {
+			++x;
+		}
+		Span.begin = x;
+		while (x < End && !(_columnCoverStart[x] <= Y && Y <= _columnCoverEnd[x])) {
+			++x;
+		}
+		Span.end = x;
+		if (Span.end > Span.begin) {
+			Kernel(Span);
 		}
 	}
 }
 void RCRenderer::RenderSkyBox(const int &Width, const int &Height, const float &Pitch,
-                  const int& FogConstant, const vecmath::Vector<float>& RayRightDirection,
-                  const vecmath::Vector<float>& RayLeftDirection, const int &Start) {
+                  const vecmath::Vector<float>& RayRightDirection,
+                  const vecmath::Vector<float>& RayLeftDirection, const int &Start, const int &End) {
 	auto bufferPointer = _enableResolution ? _resolutionRenderTarget->_backBuffer : _renderTarget->_backBuffer;
 	auto skyboxTextureWidth  = _scene->_skyBoxTexture->_context->GetWidth();
 	auto skyboxTextureHeight = _scene->_skyBoxTexture->_context->GetHeight();
@@ -270,16 +1017,42 @@ void RCRenderer::RenderSkyBox(const int &Width, const int &Height, const float &
 	int deltaTextureY = skyboxTextureHeight * (Height / 2 + Pitch) / (Height / 2 + PitchMax) - 1;
 	int textureYRight = skyboxTextureHeight - 1 - deltaTextureY;
 	int relativeX     = 0;
-	for (int x = Start; x < Width; ++x) {
+	// 从第 Start 列开始渲染时，需要先推算出前 Start 列累计的纹理步进，
+	// 与逐列执行 relativeX += deltaTextureX; while (relativeX > Width) { ... } 的结果一致
+	if (Start > 0) {
+		const long long total   = static_cast<long long>(Start) * deltaTextureX;
+		const long long advance = total > 0 ? (total - 1) / Width : 0;
+		textureXRight += static_cast<int>(advance);
+		relativeX      = static_cast<int>(total - advance * Width);
+	}
+	for (int x = Start; x < End; ++x) {
 		if (textureXRight >= skyboxTextureWidth) {
 			textureX = textureXRight - skyboxTextureWidth;
 		}
 		else {
 			textureX = textureXRight;
 		}
+		// 被墙体覆盖的行 [skipStart, skipEnd] 无需渲染
+		int skipStart = Height;
+		int skipEnd   = -1;
+		if (_enableOverdrawCulling && _columnCoverStart[x] <= _columnCoverEnd[x]) {
+			skipStart = _columnCoverStart[x];
+			skipEnd   = _columnCoverEnd[x];
+		}
+
 		int textureY  = 0;
 		int relativeY = 0;
 		for (int y = 0; y < deltaY; ++y) {
+			if (y == skipStart) {
+				// 直接推算出跳过这些行之后的纹理步进，与逐行累加的结果一致
+				const int total = (skipEnd + 1) * deltaTextureY;
+				textureY  = total > 0 ? (total - 1) / deltaY : 0;
+				relativeY = total - textureY * deltaY;
+				y         = skipEnd;
+
+				continue;
+			}
+
 			COLORREF color = _scene->_skyBoxTexture->_buffer[skyboxTextureWidth * textureY + textureX];
 			bufferPointer[y * Width + x] = color;
 
@@ -289,6 +1062,10 @@ void RCRenderer::RenderSkyBox(const int &Width, const int &Height, const float &
 				relativeY   -= deltaY;
 			}
 		}
+		// 天空盒与地板之间的一行不属于任何一方，填充为黑色
+		if (deltaY >= 0 && deltaY < Height && (deltaY < skipStart || deltaY > skipEnd)) {
+			bufferPointer[deltaY * Width + x] = 0;
+		}
 
 		relativeX += deltaTextureX;
 		while (relativeX > Width) {
@@ -297,250 +1074,202 @@ void RCRenderer::RenderSkyBox(const int &Width, const int &Height, const float &
 		}
 	}
 }
-void RCRenderer::RayCasting(const int &Width, const int &Height, const float &Pitch,
-                            const int &FogConstant, const vecmath::Vector<float> &RayRightDirection,
-                            const vecmath::Vector<float> &RayLeftDirection, const int &Start) {
-	auto bufferPointer = _enableResolution ? _resolutionRenderTarget->_backBuffer : _renderTarget->_backBuffer;
-	for (int x = Start; x < Width; ++x) {
-		float cameraX = 2.f * static_cast<float>(x) / static_cast<float>(_renderTargetWidth) - 1;
-		vecmath::Vector<float> rayDirection = _camera->Direction + _camera->Plane * cameraX;
-
-		/**
-		 * 击中物体的方向
-		 */
-		auto objects = _mapObjectMemoryPool.allocate(10);
-		auto size = 0;
-		float furtherDistance;
-		{
-			int mapX = static_cast<int>(_camera->Position.x);
-			int mapY = static_cast<int>(_camera->Position.y);
-
-			RCRender::MapObject object{};
-			float sideDistanceX;
-			float sideDistanceY;
-			float deltaDistanceX = std::abs(1.f / rayDirection.x);
-			float deltaDistanceY = std::abs(1.f / rayDirection.y);
-			float perpDistance;
-			float wallX;
-
-			int stepX;
-			int stepY;
-
-			if (rayDirection.x < 0) {
-				stepX         = -1;
-				sideDistanceX = (_camera->Position.x - static_cast<float>(mapX)) * deltaDistanceX;
-			} else {
-				stepX         = 1;
-				sideDistanceX = (static_cast<float>(mapX) + 1.f - _camera->Position.x) * deltaDistanceX;
-			}
-			if (rayDirection.y < 0) {
-				stepY         = -1;
-				sideDistanceY = (_camera->Position.y - static_cast<float>(mapY)) * deltaDistanceY;
-			} else {
-				stepY         = 1;
-				sideDistanceY = (static_cast<float>(mapY) + 1.f - _camera->Position.y) * deltaDistanceY;
-			}
-
-			RCRender::HideSide hitSide;
+void RCRenderer::TraceColumns(const int &Width, const int &Height, const float &Pitch, const int &Start, const int &End,
+                              RCRender::ThreadContext &Context) {
+	// 本线程负责的各列的击中物体依次存放在同一个列表中，容量不足时在帧内存中扩容，
+	// 因此一列可以击中任意多个物体
+	Context.hitCount    = 0;
+	Context.hitCapacity = 64;
+	Context.hitList     = Context.frameArena.Allocate<RCRender::MapObject>(Context.hitCapacity);
+	long long steps     = 0;
+	const auto map      = _scene->_map;
+	// 光线前进一格，返回穿过的面
+	auto advance = [&](RCMapRay &Ray) {
+		// 借助距离场跳过光线所在格子周围的空气
+		map->SkipEmptySpace(Ray);
+		++steps;
+
+		return Ray.Step() ? RCRender::HideSide::NS : RCRender::HideSide::EW;
+	};
 
-			while (true) {
-				if (sideDistanceX < sideDistanceY) {
-					sideDistanceX += deltaDistanceX;
-					mapX += stepX;
-					hitSide = RCRender::HideSide::NS;
-				} else {
-					sideDistanceY += deltaDistanceY;
-					mapY += stepY;
-					hitSide = RCRender::HideSide::EW;
-				}
-				RCMapUnit mapUnit = _scene->_map->_mapArray[mapX + mapY * _scene->_map->_width];
-				if (mapUnit.Type != RCMapUnitType::Air) {
-					if (mapUnit.Type == RCMapUnitType::Wall) {
-						if (hitSide == RCRender::HideSide::NS) {
-							perpDistance = sideDistanceX - deltaDistanceX;
-						} else {
-							perpDistance = sideDistanceY - deltaDistanceY;
-						}
-					}
-					if (mapUnit.Type == RCMapUnitType::Door || mapUnit.Type == RCMapUnitType::Glass || mapUnit.Type == RCMapUnitType::Strip) {
-						if (hitSide == RCRender::HideSide::NS) {
-							float distance = sideDistanceX - deltaDistanceX * 0.5f;
-							if (sideDistanceY < distance) {
-								continue;
-							}
-							perpDistance = distance;
-						} else {
-							float distance = sideDistanceY - deltaDistanceY * 0.5f;
-							if (sideDistanceX < distance) {
-								continue;
-							}
-							perpDistance = distance;
-						}
+	RCRender::RayPacket    packet{};
+	vecmath::Vector<float> rayDirections[RCRender::MaxRayPacketSize];
+	packet.positionX   = _camera->Position.x;
+	packet.positionY   = _camera->Position.y;
+	packet.maxDistance = _scene->GetMaxVisibleDistance();
+	for (int packetStart = Start; packetStart < End; packetStart += RCRender::MaxRayPacketSize) {
+		const int packetSize = std::min(RCRender::MaxRayPacketSize, End - packetStart);
+		// 相邻列的光线方向相近，先以光线包同时穿过各列到第一个非空气单位之间的空气
+		for (int lane = 0; lane < packetSize; ++lane) {
+			float cameraX = 2.f * static_cast<float>(packetStart + lane) / static_cast<float>(_renderTargetWidth) - 1;
+			rayDirections[lane]     = _camera->Direction + _camera->Plane * cameraX;
+			packet.directionX[lane] = rayDirections[lane].x;
+			packet.directionY[lane] = rayDirections[lane].y;
+		}
+		_rayPacketKernel(map->_distanceField.data(), map->_width, packet, packetSize);
+
+		for (int lane = 0; lane < packetSize; ++lane) {
+			const int   x            = packetStart + lane;
+			const auto &rayDirection = rayDirections[lane];
+			steps += packet.steps[lane];
+
+			_columnHitOffset[x]  = static_cast<int>(Context.hitCount);
+			_columnCoverStart[x] = Height;
+			_columnCoverEnd[x]   = -1;
+			{
+				auto ray = packet.GetRay(lane);
+
+				const RayGeometry<RCMapRay> geometry{ _camera->Position.x, _camera->Position.y, rayDirection };
+
+				// 光线已停在第一个非空气单位上，此后的单位逐格步进
+				auto hitSide = packet.sideX[lane] != 0 ? RCRender::HideSide::NS : RCRender::HideSide::EW;
+				for (;; hitSide = advance(ray)) {
+					// 越过最大可见距离后的物体均被烟雾完全覆盖，该列其余部分由地板与天花板填充
+					if (ray.IsBeyond(packet.maxDistance)) {
+						_columnDepth[x] = packet.maxDistance;
+						break;
 					}
-					if (mapUnit.Type == RCMapUnitType::DiagWallLeftRight ||
-					    mapUnit.Type == RCMapUnitType::DiagWallRightLeft) {
-						struct Intersect {
-							float perpDistance;
-							float wallX;
-						};
-						float k;
-						float distance;
-						if (mapUnit.Type == RCMapUnitType::DiagWallLeftRight) {
-							k        = 1.f;
-							distance = _camera->Position.x - mapX - _camera->Position.y + mapY;
-							if (rayDirection.y != rayDirection.x) {
-								perpDistance = (mapY + k * (_camera->Position.x - mapX) - _camera->Position.y) / (rayDirection.y - k * rayDirection.x);
-								wallX        = (_camera->Position.x + rayDirection.x * perpDistance - mapX);
-							} else {
-								wallX        = -1;
-								perpDistance = -1;
-							}
-						}
-						else {
-							k        = -1.f;
-							distance = mapX - _camera->Position.x - _camera->Position.y + mapY + 1;
-							if (rayDirection.y != rayDirection.x) {
-								perpDistance = (mapY + 1.f + k * (_camera->Position.x - mapX) - _camera->Position.y) / (rayDirection.y - k * rayDirection.x);
-								wallX        = _camera->Position.x + rayDirection.x * perpDistance - mapX;
-							} else {
-								wallX        = -1;
-								perpDistance = -1;
-							}
-						}
-
-						if (wallX < 0.f || wallX >= 1.f) {
+					const int position = ray.mapX + ray.mapY * map->_width;
+					if (!map->IsEmpty(position)) {
+						// 只有击中非空气的单位时才读取完整的单位
+						const RCMapUnit     mapUnit = map->GetMapUnit(position);
+						RCRender::MapObject object{};
+						if (!ClassifyHit(geometry, ray, mapUnit, hitSide, object)) {
 							continue;
 						}
-
-						if (distance < 0) {
-							wallX = 1.f - wallX;
-						}
-
-						hitSide = RCRender::HideSide::DIG;
-					}
-					else {
-						if (hitSide == RCRender::HideSide::NS) {
-							wallX = _camera->Position.y + perpDistance * rayDirection.y;
-						} else {
-							wallX = _camera->Position.x + perpDistance * rayDirection.x;
+						if (RecordHit(object, x, Height, Pitch, Context)) {
+							break;
 						}
-						wallX -= floor(wallX);
-					}
-
-					object.sideDistanceX  = sideDistanceX;
-					object.sideDistanceY  = sideDistanceY;
-					object.perpDistance   = perpDistance;
-					object.deltaDistanceX = deltaDistanceX;
-					object.deltaDistanceY = deltaDistanceY;
-					object.unit           = mapUnit;
-					object.hitSide        = hitSide;
-					object.mapX           = mapX;
-					object.mapY           = mapY;
-					object.wallX          = wallX;
-					objects[size] = object;
-					++size;
-					if (mapUnit.Type == RCMapUnitType::Door && mapUnit.Door->Max > mapUnit.Door->Offset) {
-						continue;
-					}
-					if (mapUnit.Type == RCMapUnitType::Glass || mapUnit.Type == RCMapUnitType::Strip
-					    || mapUnit.Type == RCMapUnitType::DiagWallLeftRight || mapUnit.Type == RCMapUnitType::DiagWallRightLeft) {
-						continue;
-					}
-					else {
-						furtherDistance = perpDistance;
-
-						break;
 					}
 				}
 			}
+			_columnHitCount[x] = static_cast<int>(Context.hitCount) - _columnHitOffset[x];
 		}
-
-		auto spriteList = _spriteMemoryPool.allocate(_scene->SpriteCount);
-		int spriteCount = 0;
-		for (int count = 0; count < _scene->SpriteCount; ++count) {
-			RCRender::Sprite sprite{};
-			auto spriteTarget = _scene->SpriteList[count];
-			auto textureWidth   = spriteTarget->texture->_context->GetWidth();
-			auto textureHeight  = spriteTarget->texture->_context->GetWidth();
-			float spriteX = spriteTarget->x - _camera->Position.x;
-			float spriteY = spriteTarget->y - _camera->Position.y;
-
-			float invDet = 1.f / (_camera->Plane.x * _camera->Direction.y - _camera->Direction.x * _camera->Plane.y);
-
-			float transformX = invDet * (_camera->Direction.y * spriteX - _camera->Direction.x * spriteY);
-			sprite.transformY = invDet * (-_camera->Plane.y * spriteX + _camera->Plane.x * spriteY);
-
-			if (sprite.transformY < 0) {
-				continue;
+	}
+	Context.traceSteps = steps;
+}
+void RCRenderer::TraceColumnsFixed(const int &Width, const int &Height, const float &Pitch, const int &Start,
+                                   const int &End, RCRender::ThreadContext &Context) {
+	Context.hitCount    = 0;
+	Context.hitCapacity = 64;
+	Context.hitList     = Context.frameArena.Allocate<RCRender::MapObject>(Context.hitCapacity);
+	long long steps     = 0;
+	const auto map      = _scene->_map;
+
+	constexpr long long one        = RCMapFixedRay::One;
+	const int           positionX  = RCMapFixedRay::ToFixed(_camera->Position.x);
+	const int           positionY  = RCMapFixedRay::ToFixed(_camera->Position.y);
+	const float         maxVisible = _scene->GetMaxVisibleDistance();
+	const long long     limit      = std::isinf(maxVisible) ? std::numeric_limits<long long>::max()
+	                                                        : std::llround(static_cast<double>(maxVisible) * one);
+	for (int x = Start; x < End; ++x) {
+		const auto &column = _fixedColumns[x];
+		RCMapFixedRay ray(positionX, positionY, column.directionX, column.directionY, column.deltaDistanceX,
+		                  column.deltaDistanceY);
+		const RayGeometry<RCMapFixedRay> geometry{ positionX, positionY, column.directionX, column.directionY };
+
+		_columnHitOffset[x]  = static_cast<int>(Context.hitCount);
+		_columnCoverStart[x] = Height;
+		_columnCoverEnd[x]   = -1;
+		while (true) {
+			map->SkipEmptySpace(ray);
+			++steps;
+			auto hitSide = ray.Step() ? RCRender::HideSide::NS : RCRender::HideSide::EW;
+			if (ray.IsBeyond(limit)) {
+				_columnDepth[x] = maxVisible;
+				break;
 			}
 
-			int spriteScreenX = int(_renderTargetWidth / 2 * (1 + transformX / sprite.transformY));
-
-			int vMoveScreen = int(spriteTarget->z / sprite.transformY);
-
-			int spriteHeight = abs(int(_renderTargetHeight / sprite.transformY));
-			sprite.drawStartY = -spriteHeight / 2 + _renderTargetHeight / 2 + vMoveScreen + Pitch + _camera->Z / sprite.transformY;
-			sprite.drawEndY = spriteHeight / 2 + _renderTargetHeight / 2 + vMoveScreen + Pitch + _camera->Z / sprite.transformY;
-
-			int spriteWidth = abs(int(_renderTargetHeight / sprite.transformY));
-			sprite.drawStartX = -spriteWidth / 2 + spriteScreenX;
-			sprite.drawEndX = spriteWidth / 2 + spriteScreenX;
-
-			if (sprite.drawStartX >= _renderTargetWidth || sprite.drawEndX < 0) {
+			const int position = ray.mapX + ray.mapY * map->_width;
+			if (map->IsEmpty(position)) {
 				continue;
 			}
-
-			// Precompute some variables for the vertical strips
-			sprite.deltaY = sprite.drawEndY - sprite.drawStartY;
-			sprite.countY = 0;
-			sprite.textureY = 0;
-			if (sprite.drawStartY < 0) {
-				sprite.countY = -sprite.drawStartY * textureHeight;
-				if (sprite.countY > sprite.deltaY) {
-					div_t res = div(sprite.countY, sprite.deltaY);
-					sprite.textureY += res.quot;
-					sprite.countY = res.rem;
-				}
-				sprite.drawStartY = 0;
+			const RCMapUnit     mapUnit = map->GetMapUnit(position);
+			RCRender::MapObject object{};
+			if (!ClassifyHit(geometry, ray, mapUnit, hitSide, object)) {
+				continue;
 			}
-			if (sprite.drawEndY >= _renderTargetHeight) {
-				sprite.drawEndY = _renderTargetHeight - 1;
+			if (RecordHit(object, x, Height, Pitch, Context)) {
+				break;
 			}
+		}
+		_columnHitCount[x] = static_cast<int>(Context.hitCount) - _columnHitOffset[x];
+	}
+	Context.traceSteps = steps;
+}
+void RCRenderer::UpdateFixedColumns() {
+	const std::array<int, 4> camera = {
+		RCMapFixedRay::ToFixed(_camera->Direction.x), RCMapFixedRay::ToFixed(_camera->Direction.y),
+		RCMapFixedRay::ToFixed(_camera->Plane.x), RCMapFixedRay::ToFixed(_camera->Plane.y)
+	};
+	// 各列的倒数只与相机的朝向与画面宽度有关，平移时无需重建
+	if (static_cast<int>(_fixedColumns.size()) == _renderTargetWidth && camera == _fixedColumnCamera) {
+		return;
+	}
 
-			sprite.textureX = 0;
-			sprite.deltaX = sprite.drawEndX - sprite.drawStartX;
-			sprite.countX = 0;
+	_fixedColumnCamera = camera;
+	_fixedColumns.resize(_renderTargetWidth);
+	for (int x = 0; x < _renderTargetWidth; ++x) {
+		_fixedColumns[x] = RCRender::MakeFixedColumn(camera[0], camera[1], camera[2], camera[3], x, _renderTargetWidth);
+	}
+}
+void RCRenderer::GetWallRows(const float &PerpDistance, const float &Pitch, int &DrawStart, int &DrawEnd) const {
+	int lineHeight = static_cast<int>(_renderTargetHeight / PerpDistance);
+	DrawStart      = -lineHeight / 2 + _renderTargetHeight / 2 + Pitch + _camera->Z / PerpDistance;
+	DrawEnd        = lineHeight / 2 + _renderTargetHeight / 2 + Pitch + _camera->Z / PerpDistance;
+}
+bool RCRenderer::RecordHit(const RCRender::MapObject &Object, const int &X, const int &Height, const float &Pitch,
+                           RCRender::ThreadContext &Context) {
+	if (Context.hitCount == Context.hitCapacity) {
+		Context.hitList      = Context.frameArena.Grow(Context.hitList, Context.hitCapacity, Context.hitCapacity * 2);
+		Context.hitCapacity *= 2;
+	}
+	Context.hitList[Context.hitCount++] = Object;
 
-			if (sprite.drawStartX < 0) {
-				sprite.countX = -sprite.drawStartX * textureWidth;
-				if (sprite.countX > sprite.deltaX)
-				{
-					div_t res = div(sprite.countX, sprite.deltaX);
-					sprite.textureX += res.quot;
-					sprite.countX = res.rem;
-				}
-				sprite.drawStartX = 0;
-			}
-			if (sprite.drawEndX > _renderTargetWidth) {
-				sprite.drawEndX = _renderTargetWidth;
-			}
+	const auto &mapUnit = Object.unit;
+	const auto &traits  = GetMapUnitTraits(mapUnit.Type);
+	if (!traits.blocksRay || (traits.door && mapUnit.Door->Max > mapUnit.Door->Offset)) {
+		return false;
+	}
 
-			if (_scene->_enableFog) {
-				sprite.fog = sprite.transformY / static_cast<float>(FogConstant) * _scene->_fogLevel;
-			}
+	const float perpDistance = Object.perpDistance;
+	_columnDepth[X] = perpDistance;
 
-			sprite.texture = spriteTarget->texture;
-			spriteList[count] = sprite;
+	// 记录不透明墙体覆盖的行，这些行一定会被墙体写入，背景无需再渲染
+	auto textureWidth = mapUnit.Texture->_context->GetWidth();
+	if (mapUnit.Texture->IsOpaque() &&
+	    (!traits.door || mapUnit.Door->Offset >= textureWidth)) {
+		int drawStart;
+		int drawEnd;
+		GetWallRows(perpDistance, Pitch, drawStart, drawEnd);
 
-			++spriteCount;
-		}
+		_columnCoverStart[X] = std::max(drawStart, 0);
+		_columnCoverEnd[X]   = std::min(drawEnd, Height - 1);
+	}
 
-		std::sort(spriteList, spriteList + _scene->SpriteCount, [](const RCRender::Sprite &Left, const RCRender::Sprite &Right) -> bool {
-			return Left.transformY < Right.transformY;
-		});
+	return true;
+}
+void RCRenderer::RayCasting(const int &Width, const int &Height, const float &Pitch,
+                            const vecmath::Vector<float> &RayRightDirection,
+                            const vecmath::Vector<float> &RayLeftDirection, const int &Start, const int &End,
+                            RCRender::ThreadContext &Context) {
+	auto bufferPointer = _enableResolution ? _resolutionRenderTarget->_backBuffer : _renderTarget->_backBuffer;
+	for (int x = Start; x < End; ++x) {
+		float cameraX = 2.f * static_cast<float>(x) / static_cast<float>(_renderTargetWidth) - 1;
+		vecmath::Vector<float> rayDirection = _camera->Direction + _camera->Plane * cameraX;
+
+		// 当前列的第 y 个像素位于 column[y * _renderTargetWidth]
+		DWORD *column = bufferPointer + x;
 
-		int farSprite = spriteCount - 1;
-		while (farSprite >= 0 && spriteList[farSprite].transformY > furtherDistance) {
+		// 击中的物体，由近到远排列
+		auto  objects         = Context.hitList + _columnHitOffset[x];
+		auto  size            = _columnHitCount[x];
+		float furtherDistance = _columnDepth[x];
+
+		// 当前列的精灵下标，已按照距离由近到远排序
+		const int *columnSprites = _spriteColumnIndex + _spriteColumnOffset[x];
+		int        farSprite     = _spriteColumnOffset[x + 1] - _spriteColumnOffset[x] - 1;
+		while (farSprite >= 0 && _spriteList[columnSprites[farSprite]].transformY > furtherDistance) {
 			farSprite--;
 		}
 		for (int posCount = size - 1; posCount >= 0; --posCount) {
@@ -556,17 +1285,18 @@ void RCRenderer::RayCasting(const int &Width, const int &Height, const float &Pi
 			auto wallX          = objects[posCount].wallX;
 
 			// 是否需要透明度混合
-			bool transparentPass = mapUnit.Type == RCMapUnitType::Glass;
+			const auto &traits          = GetMapUnitTraits(mapUnit.Type);
+			bool        transparentPass = traits.translucent;
 
-			int lineHeight = static_cast<int>(_renderTargetHeight / perpDistance);
-			int drawStart  = -lineHeight / 2 + _renderTargetHeight / 2 + Pitch + _camera->Z / perpDistance;
-			int drawEnd    = lineHeight / 2 + _renderTargetHeight / 2 + Pitch + _camera->Z / perpDistance;
+			int drawStart;
+			int drawEnd;
+			GetWallRows(perpDistance, Pitch, drawStart, drawEnd);
 
 			auto textureWidth  = mapUnit.Texture->_context->GetWidth();
 			auto textureHeight = mapUnit.Texture->_context->GetHeight();
 			int textureX       = static_cast<int>(wallX * double(textureWidth));
 			// 如果是门，计算位移
-			if (mapUnit.Type == RCMapUnitType::Door) {
+			if (traits.door) {
 				textureX -= textureWidth - mapUnit.Door->Offset;
 				if (textureX < 0) {
 					continue;
@@ -581,15 +1311,24 @@ void RCRenderer::RayCasting(const int &Width, const int &Height, const float &Pi
 				textureX = textureWidth - textureX - 1;
 			}
 
-			float fog;
-			if (_scene->_enableFog) {
-				fog = perpDistance / FogConstant * _scene->_fogLevel;
-			}
+			// 远处的墙体每个像素跨越多个纹素，改为读取更小的 mipmap 层级
+			const int   mipLevel = _enableMipmap ? mapUnit.Texture->SelectMipLevel(
+				static_cast<float>(textureHeight) * perpDistance / static_cast<float>(_renderTargetHeight)) : 0;
+			const auto &mip      = mapUnit.Texture->_mipLevels[mipLevel];
+			textureX      >>= mipLevel;
+			textureWidth    = mip.width;
+			textureHeight   = mip.height;
+
+			// 明暗面的通道右移位数，启用烟雾时在查找烟雾颜色表前完成
+			const int   shade    = hitSide == RCRender::HideSide::NS ? 1 : (hitSide == RCRender::HideSide::DIG ? 2 : 0);
+			const BYTE *colormap = _scene->_enableFog ? _scene->GetFogColormap(perpDistance) : nullptr;
 			if (drawStart < 0) {
 				count = -drawStart * textureHeight;
-				if (count > deltaY) {
-					div_t divResult = div(count, deltaY);
-					count           = divResult.rem;
+				if (deltaY > 0 && count > deltaY) {
+					// 与逐像素累加一致，余数的范围为 (0, deltaY]，否则整除时纹理纵坐标会多前进一行，
+					// 整列都在画布上方时最后一个像素将越过纹理底部
+					div_t divResult = div(count - 1, deltaY);
+					count           = divResult.rem + 1;
 					textureY += divResult.quot;
 				}
 				drawStart = 0;
@@ -598,109 +1337,185 @@ void RCRenderer::RayCasting(const int &Width, const int &Height, const float &Pi
 				drawEnd = Height - 1;
 			}
 
-			while (farSprite >= 0 && spriteList[farSprite].transformY > perpDistance) {
-				auto sprite = spriteList[farSprite];
-				RenderSprite(sprite, x, sprite.fog);
+			RCRender::ColumnSpan span{};
+			span.textureY = textureY;
+			span.stepper  = RCRender::MakeTextureStepper(textureY, count, textureHeight, deltaY);
+			// 该列的纹素：按列存储时是连续的，否则每个纹素相隔一行
+			span.texels       = mip.columnBuffer != nullptr ? mip.columnBuffer + textureX * textureHeight
+			                                                : mip.buffer + textureX;
+			span.texelStride  = mip.columnBuffer != nullptr ? 1 : textureWidth;
+			span.colormap     = colormap;
+			span.output       = column;
+			span.outputStride = _renderTargetWidth;
+			span.begin        = drawStart;
+			span.end          = drawEnd + 1;
+
+			while (farSprite >= 0 && _spriteList[columnSprites[farSprite]].transformY > perpDistance) {
+				auto &sprite = _spriteList[columnSprites[farSprite]];
+				RenderSprite(sprite, x, column);
 				--farSprite;
 			}
-			for (int y = drawStart; y <= drawEnd; ++y) {
-				COLORREF color = mapUnit.Texture->_buffer[textureY * textureWidth + textureX];
-				// 如果 Alpha 通道不为零，则尝试绘制
-				if (((color & 0xFF000000)) != 0) {
-					// 明暗面处理
-					if (hitSide == RCRender::HideSide::NS) {
-						color = (color >> 1) & 8355711;
-					} else if (hitSide == RCRender::HideSide::DIG) {
-						color = (color >> 2) & 0x3F3F3F;
-					}
+			// 依据烟雾、混合与明暗面选择特化的内核
+			unsigned features = static_cast<unsigned>(shade) << 2;
+			if (colormap != nullptr) {
+				features |= RCRender::ColumnFeature::Fog;
+			}
+			if (transparentPass) {
+				features |= RCRender::ColumnFeature::Blend;
+			}
+			RCRender::GetColumnKernel(features)(span);
+		}
+		while (farSprite >= 0) {
+			auto &sprite = _spriteList[columnSprites[farSprite]];
+			RenderSprite(sprite, x, column);
+			--farSprite;
+		}
+	}
+}
+void RCRenderer::PrepareSprites(const float &Pitch) {
+	_spriteList  = _frameArena.Allocate<RCRender::Sprite>(_scene->SpriteCount);
+	_spriteCount = 0;
+	_columnDepth = _frameArena.Allocate<float>(_renderTargetWidth);
+
+	// 整帧只需投影一次精灵
+	const float maxVisible = _scene->GetMaxVisibleDistance();
+	float invDet = 1.f / (_camera->Plane.x * _camera->Direction.y - _camera->Direction.x * _camera->Plane.y);
+	for (int count = 0; count < _scene->SpriteCount; ++count) {
+		RCRender::Sprite sprite{};
+		auto spriteTarget = _scene->SpriteList[count];
+		float spriteX = spriteTarget->x - _camera->Position.x;
+		float spriteY = spriteTarget->y - _camera->Position.y;
+
+		float transformX = invDet * (_camera->Direction.y * spriteX - _camera->Direction.x * spriteY);
+		sprite.transformY = invDet * (-_camera->Plane.y * spriteX + _camera->Plane.x * spriteY);
+
+		// 位于相机之后，或越过最大可见距离而被烟雾完全覆盖
+		if (sprite.transformY < 0 || sprite.transformY >= maxVisible) {
+			continue;
+		}
 
-					if (_scene->_enableFog) {
-						auto &buffer = bufferPointer[y * _renderTargetWidth + x];
-						if (fog >= 1) {
-							color = _scene->_fogColor;
-						} else if (fog > 0) {
-							auto r = GetRValue(color) * (1 - fog) + _fogColorR * fog;
-							auto g = GetGValue(color) * (1 - fog) + _fogColorG * fog;
-							auto b = GetBValue(color) * (1 - fog) + _fogColorB * fog;
+		int spriteScreenX = int(_renderTargetWidth / 2 * (1 + transformX / sprite.transformY));
 
-							color = RGB(r, g, b);
-						}
-					}
+		int vMoveScreen = int(spriteTarget->z / sprite.transformY);
 
-					if (transparentPass) {
-						color = ((color & 0xFEFEFE) >> 1) + ((bufferPointer[y * _renderTargetWidth + x] & 0xFEFEFE) >> 1);
-					}
-					bufferPointer[y * _renderTargetWidth + x] = color;
-				}
+		int spriteHeight = abs(int(_renderTargetHeight / sprite.transformY));
+		sprite.drawStartY = -spriteHeight / 2 + _renderTargetHeight / 2 + vMoveScreen + Pitch + _camera->Z / sprite.transformY;
+		sprite.drawEndY = spriteHeight / 2 + _renderTargetHeight / 2 + vMoveScreen + Pitch + _camera->Z / sprite.transformY;
 
-				count += textureHeight;
-				while (count > deltaY) {
-					++textureY;
-					count -= deltaY;
-				}
+		int spriteWidth = abs(int(_renderTargetHeight / sprite.transformY));
+		sprite.drawStartX = -spriteWidth / 2 + spriteScreenX;
+		sprite.drawEndX = spriteWidth / 2 + spriteScreenX;
+
+		if (sprite.drawStartX >= _renderTargetWidth || sprite.drawEndX < 0) {
+			continue;
+		}
+
+		// 远处的精灵读取更小的 mipmap 层级
+		const int   mipLevel = _enableMipmap ? spriteTarget->texture->SelectMipLevel(
+			static_cast<float>(spriteTarget->texture->_context->GetHeight()) * sprite.transformY /
+			static_cast<float>(_renderTargetHeight)) : 0;
+		const auto &mip      = spriteTarget->texture->_mipLevels[mipLevel];
+		const int   textureWidth  = mip.width;
+		const int   textureHeight = mip.height;
+
+		sprite.textureBuffer       = mip.buffer;
+		sprite.textureColumnBuffer = mip.columnBuffer;
+		sprite.textureWidth        = textureWidth;
+		sprite.textureHeight       = textureHeight;
+
+		// Precompute some variables for the vertical strips
+		sprite.deltaY = sprite.drawEndY - sprite.drawStartY;
+		sprite.countY = 0;
+		sprite.textureY = 0;
+		if (sprite.drawStartY < 0) {
+			sprite.countY = -sprite.drawStartY * textureHeight;
+			if (sprite.deltaY > 0 && sprite.countY > sprite.deltaY) {
+				div_t res = div(sprite.countY - 1, sprite.deltaY);
+				sprite.textureY += res.quot;
+				sprite.countY = res.rem + 1;
 			}
+			sprite.drawStartY = 0;
 		}
-		while (farSprite >= 0) {
-			RenderSprite(spriteList[farSprite], x, spriteList[farSprite].fog);
-			--farSprite;
+		if (sprite.drawEndY >= _renderTargetHeight) {
+			sprite.drawEndY = _renderTargetHeight - 1;
+		}
+		sprite.stepperY = RCRender::MakeTextureStepper(sprite.textureY, sprite.countY, textureHeight, sprite.deltaY);
+
+		sprite.textureX = 0;
+		sprite.deltaX = sprite.drawEndX - sprite.drawStartX;
+		sprite.countX = 0;
+
+		if (sprite.drawStartX < 0) {
+			sprite.countX = -sprite.drawStartX * textureWidth;
+			if (sprite.countX > sprite.deltaX)
+			{
+				div_t res = div(sprite.countX, sprite.deltaX);
+				sprite.textureX += res.quot;
+				sprite.countX = res.rem;
+			}
+			sprite.drawStartX = 0;
 		}
+		if (sprite.drawEndX > _renderTargetWidth) {
+			sprite.drawEndX = _renderTargetWidth;
+		}
+
+		sprite.colormap = _scene->_enableFog ? _scene->GetFogColormap(sprite.transformY) : nullptr;
+		sprite.index    = count;
+
+		_spriteList[_spriteCount++] = sprite;
+	}
+
+	std::sort(_spriteList, _spriteList + _spriteCount, [](const RCRender::Sprite &Left, const RCRender::Sprite &Right) -> bool {
+		return Left.transformY < Right.transformY;
+	});
 
-		_mapObjectMemoryPool.deallocate(objects);
-		_spriteMemoryPool.deallocate(spriteList);
+	// 建立每一列的精灵索引（计数排序），列内的精灵保持由近到远的顺序
+	_spriteColumnOffset = _frameArena.Allocate<int>(_renderTargetWidth + 1);
+	std::fill(_spriteColumnOffset, _spriteColumnOffset + _renderTargetWidth + 1, 0);
+	for (int index = 0; index < _spriteCount; ++index) {
+		for (int x = _spriteList[index].drawStartX; x < _spriteList[index].drawEndX; ++x) {
+			++_spriteColumnOffset[x + 1];
+		}
 	}
+	for (int x = 0; x < _renderTargetWidth; ++x) {
+		_spriteColumnOffset[x + 1] += _spriteColumnOffset[x];
+	}
+	_spriteColumnIndex = _frameArena.Allocate<int>(_spriteColumnOffset[_renderTargetWidth]);
+	auto columnCursor  = _frameArena.Allocate<int>(_renderTargetWidth);
+	std::copy(_spriteColumnOffset, _spriteColumnOffset + _renderTargetWidth, columnCursor);
+	for (int index = 0; index < _spriteCount; ++index) {
+		for (int x = _spriteList[index].drawStartX; x < _spriteList[index].drawEndX; ++x) {
+			_spriteColumnIndex[columnCursor[x]++] = index;
+		}
+	}
+
 }
-void RCRenderer::RenderSprite(RCRender::Sprite& sprite, const int &x, const float& fog) {
-	auto bufferPointer = _enableResolution ? _resolutionRenderTarget->_backBuffer : _renderTarget->_backBuffer;
-	auto spriteTextureHeight = sprite.texture->_context->GetHeight();
-	auto spriteTextureWidth = sprite.texture->_context->GetWidth();
+void RCRenderer::RenderSprite(const RCRender::Sprite& sprite, const int &x, DWORD *Column) {
 	if (x < sprite.drawStartX || x >= sprite.drawEndX) {
 		return;
 	}
 
-	int delta = x - sprite.drawStartX;
+	// 精灵由所有渲染线程共享，因此只在本地计算当前列的纹理 X 坐标
+	int textureX = sprite.textureX;
+	int delta    = x - sprite.drawStartX;
 	if (delta != 0) {
-		sprite.drawStartX += delta;
-		div_t res = div(sprite.countX + delta * spriteTextureHeight, sprite.deltaX);
-		sprite.textureX += res.quot;
-		sprite.countX = res.rem;
+		div_t res = div(sprite.countX + delta * sprite.textureWidth, sprite.deltaX);
+		textureX += res.quot;
 	}
 
-	int spriteTextureY = sprite.textureY;
-	int countY = sprite.countY;
-	for (int y = sprite.drawStartY; y <= sprite.drawEndY; ++y)
-	{
-		COLORREF color = sprite.texture->_buffer[spriteTextureWidth * spriteTextureY + sprite.textureX];
-		if (((color & 0xFF000000)) != 0)
-		{
-			if (_scene->_enableFog) {
-				if (fog >= 1) {
-					color = _scene->_fogColor;
-				} else if (fog > 0) {
-					auto r = GetRValue(color) * (1 - fog) + _fogColorR * fog;
-					auto g = GetGValue(color) * (1 - fog) + _fogColorG * fog;
-					auto b = GetBValue(color) * (1 - fog) + _fogColorB * fog;
-
-					color = RGB(r, g, b);
-				}
-			}
-			bufferPointer[y * _renderTargetWidth + x] = color;
-		}
-
-		countY += spriteTextureHeight;
-		while (countY > sprite.deltaY)
-		{
-			++spriteTextureY;
-			countY -= sprite.deltaY;
-		}
-	}
-
-	++sprite.drawStartX;
-	sprite.countX += spriteTextureWidth;
-	while (sprite.countX > sprite.deltaX)
-	{
-		++sprite.textureX;
-		sprite.countX -= sprite.deltaX;
-	}
+	RCRender::ColumnSpan span{};
+	// 该列的纹素：按列存储时是连续的，否则每个纹素相隔一行
+	span.texels       = sprite.textureColumnBuffer != nullptr
+	                    ? sprite.textureColumnBuffer + textureX * sprite.textureHeight : sprite.textureBuffer + textureX;
+	span.texelStride  = sprite.textureColumnBuffer != nullptr ? 1 : sprite.textureWidth;
+	span.textureY     = sprite.textureY;
+	span.stepper      = sprite.stepperY;
+	span.colormap     = sprite.colormap;
+	span.output       = Column;
+	span.outputStride = _renderTargetWidth;
+	span.begin        = sprite.drawStartY;
+	span.end          = sprite.drawEndY + 1;
+	RCRender::GetColumnKernel(sprite.colormap != nullptr ? RCRender::ColumnFeature::Fog : 0)(span);
 }
 #ifdef _RC_RENDER_DEBUGER_
 void RCRenderer::OutDebugText() {
@@ -713,7 +1528,10 @@ void RCRenderer::OutDebugText() {
 	 std::format(_T("  SkyBox : {}"), _scene->_enableSkybox ? _T("Enable") : _T("Disable")),
 	 std::format(_T("  Fog : {}"), _scene->_enableFog ? _T("Enable") : _T("Disable")),
 	 std::format(_T("  Fog Level : {}"), _scene->_fogLevel),
-	 std::format(_T("  Enable X2 Super Resolution : {}"), _enableResolution ? _T("Enable") : _T("Disable")),
+	 std::format(_T("  Render Scale : {:.3f}"), _renderScale),
+	 std::format(_T("  Frame Time : {:.2f} ms"), _frameTime),
+	 std::format(_T("  Wall Pass : {:.2f} ms"), _wallPassTime),
+	 std::format(_T("  Column-Major Textures : {} KiB"), GetStatistics().columnMajorTextureSize / 1024),
 	 std::format(_T("RCEngine Camera information:")),
 	 std::format(_T("  Pitch : {}"), _camera->_pitch),
 	 std::format(_T("  Camera-Z : {}"), _camera->Z)
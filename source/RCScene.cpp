@@ -27,45 +27,114 @@
 
 #include <include/RCScene.h>
 
+#include <limits>
+
 RCScene::RCScene(RCMap *Map)
-    : _map(Map), _skyBoxTexture(nullptr), _floorTexture(nullptr), _ceilingTexture(nullptr),
-	 _fogColor(0xA09EE7), _enableSkybox(false), _enableFog(false), _skyboxRepeats(1) {
+    : _fogColormapLevels(64), _fogLevel(1), _skyboxRepeats(1), _enableSkybox(false), _enableFog(false),
+	 _enableFixedPointTraversal(false), _enableFogCulling(false), _fogColor(0xA09EE7), _skyBoxTexture(nullptr),
+	 _floorTexture(nullptr), _ceilingTexture(nullptr), _map(Map), _version(0) {
 	if (Map == nullptr) {
 		throw RCInvalidParameterException("nullptr", "RCScene construction");
 	}
+
+	RebuildFogColormap();
+	UpdateFogDistanceScale();
 }
 void RCScene::SetSkyBoxTexture(RCTexture *Texture) {
 	if (Texture == nullptr) {
 		throw RCInvalidParameterException("nullptr", "RCScene.SetSkyBox");
 	}\
 	_skyBoxTexture = Texture;
+	++_version;
 }
 void RCScene::SetCeilingTexture(RCTexture *Texture) {
 	if (Texture == nullptr) {
 		throw RCInvalidParameterException("nullptr", "RCScene.SetCeilingTexture");
 	}
 	_ceilingTexture = Texture;
+	++_version;
 }
 void RCScene::SetFloorTexture(RCTexture *Texture) {
 	if (Texture == nullptr) {
 		throw RCInvalidParameterException("nullptr", "RCScene.SetFloorTexture");
 	}
 	_floorTexture = Texture;
+	++_version;
 }
 void RCScene::SetFogColor(const COLORREF &Color) {
 	_fogColor = BGR(Color);
+	++_version;
+
+	RebuildFogColormap();
 }
 void RCScene::SetFogLevel(const float &Level) {
 	_fogLevel = Level;
+	++_version;
+
+	UpdateFogDistanceScale();
+}
+void RCScene::SetFogColormapLevels(const int &Levels) {
+	if (Levels < 2 || Levels > 256) {
+		throw RCInvalidParameterException("Levels out of range [2, 256]", "RCScene.SetFogColormapLevels");
+	}
+	_fogColormapLevels = Levels;
+	++_version;
+
+	RebuildFogColormap();
+	UpdateFogDistanceScale();
+}
+int RCScene::GetFogColormapLevels() const {
+	return _fogColormapLevels;
+}
+void RCScene::RebuildFogColormap() {
+	const float fogColor[3] = { static_cast<float>(GetRValue(_fogColor)), static_cast<float>(GetGValue(_fogColor)),
+	                            static_cast<float>(GetBValue(_fogColor)) };
+
+	_fogColormap.assign(_fogColormapLevels * 768 + 4, 0);
+	for (int level = 0; level < _fogColormapLevels; ++level) {
+		const float fog     = static_cast<float>(level) / static_cast<float>(_fogColormapLevels - 1);
+		BYTE       *colormap = _fogColormap.data() + level * 768;
+		for (int channel = 0; channel < 3; ++channel) {
+			const float fogChannel = fogColor[channel] * fog;
+			for (int value = 0; value < 256; ++value) {
+				colormap[channel * 256 + value] = static_cast<BYTE>(static_cast<float>(value) * (1 - fog) + fogChannel);
+			}
+		}
+	}
+}
+void RCScene::UpdateFogDistanceScale() {
+	// 烟雾浓度为 距离 / 地图平均边长 * 烟雾等级，浓度为 1 时对应最高等级
+	_fogDistanceScale = _fogLevel / static_cast<float>(GetFogConstant()) * static_cast<float>(_fogColormapLevels - 1);
 }
 void RCScene::SetSkyboxRepeat(const unsigned short &Count) {
 	_skyboxRepeats = Count;
+	++_version;
 }
 void RCScene::EnableSkyBox(const bool &Status) {
 	_enableSkybox = Status;
+	++_version;
 }
 void RCScene::EnableFog(const bool &Status) {
 	_enableFog = Status;
+	++_version;
+}
+void RCScene::EnableFixedPointTraversal(const bool &Status) {
+	_enableFixedPointTraversal = Status;
+	++_version;
+}
+void RCScene::EnableFogCulling(const bool &Status) {
+	_enableFogCulling = Status;
+	++_version;
+}
+float RCScene::GetMaxVisibleDistance() const {
+	// 天空盒不受烟雾影响，远处的墙体会遮挡天空盒，因此不能提前停止
+	if (!_enableFog || !_enableFogCulling || _enableSkybox || !(_fogLevel > 0)) {
+		return std::numeric_limits<float>::infinity();
+	}
+
+	// 与 UpdateFogDistanceScale 一致，距离为 地图平均边长 / 烟雾等级 时烟雾浓度为 1，
+	// 此后 GetFogColormap 总是返回最高等级
+	return static_cast<float>(GetFogConstant()) / _fogLevel;
 }
 bool RCScene::CheckValid() {
 	bool flag = ((_enableSkybox) ? _skyBoxTexture != nullptr : _ceilingTexture != nullptr) &&
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2023~Now Margoo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * \file RCSpanKernel.cpp
+ * \brief 地板与天花板的行扫描内核的标量实现与运行时分发
+ */
+
+#include <include/RCSpanKernel.h>
+
+#include <algorithm>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace RCRender {
+	namespace {
+		InstructionSet QueryInstructionSet() {
+#ifdef _MSC_VER
+			int information[4];
+			__cpuid(information, 0);
+			const int maxLeaf = information[0];
+
+			__cpuid(information, 1);
+			const bool sse41   = (information[2] & (1 << 19)) != 0;
+			const bool osxsave = (information[2] & (1 << 27)) != 0;
+			const bool avx     = (information[2] & (1 << 28)) != 0;
+			bool       avx2    = false;
+			// AVX2 还需要操作系统保存 YMM 寄存器
+			if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 0x6) == 0x6) {
+				__cpuidex(information, 7, 0);
+				avx2 = (information[1] & (1 << 5)) != 0;
+			}
+#else
+			__builtin_cpu_init();
+			const bool sse41 = __builtin_cpu_supports("sse4.1");
+			const bool avx2  = __builtin_cpu_supports("avx2");
+#endif
+			if (avx2) {
+				return InstructionSet::AVX2;
+			}
+			if (sse41) {
+				return InstructionSet::SSE41;
+			}
+
+			return InstructionSet::Scalar;
+		}
+	}
+
+	InstructionSet DetectInstructionSet() {
+		static const InstructionSet set = QueryInstructionSet();
+
+		return set;
+	}
+	FloorSpanKernel GetFloorSpanKernel(const InstructionSet &Set, const unsigned &Features) {
+		// 各指令集的特化实例表，下标为 FloorFeature 的组合
+		static constexpr FloorSpanKernel scalar[FloorFeature::Count] = {
+			RenderFloorSpanScalar<0>, RenderFloorSpanScalar<1>, RenderFloorSpanScalar<2>, RenderFloorSpanScalar<3>
+		};
+		static constexpr FloorSpanKernel sse41[FloorFeature::Count] = {
+			RenderFloorSpanSSE41<0>, RenderFloorSpanSSE41<1>, RenderFloorSpanSSE41<2>, RenderFloorSpanSSE41<3>
+		};
+		static constexpr FloorSpanKernel avx2[FloorFeature::Count] = {
+			RenderFloorSpanAVX2<0>, RenderFloorSpanAVX2<1>, RenderFloorSpanAVX2<2>, RenderFloorSpanAVX2<3>
+		};
+		switch (Set) {
+			case InstructionSet::AVX2: {
+				return avx2[Features];
+			}
+			case InstructionSet::SSE41: {
+				return sse41[Features];
+			}
+			default: {
+				return scalar[Features];
+			}
+		}
+	}
+	template <unsigned Features>
+	void RenderFloorSpanScalar(const FloorSpan &Span) {
+		constexpr bool ceiling = (Features & FloorFeature::Ceiling) != 0;
+		constexpr bool fog     = (Features & FloorFeature::Fog) != 0;
+
+		// 纯烟雾行，直接填充
+		if (Span.saturated) {
+			std::fill(Span.output + Span.begin, Span.output + Span.end, (Span.fogColor >> 1) & 8355711);
+
+			return;
+		}
+
+		const auto width  = static_cast<float>(Span.textureWidth);
+		const auto height = static_cast<float>(Span.textureHeight);
+
+		for (int x = Span.begin; x < Span.end; ++x) {
+			float positionX = Span.positionX + static_cast<float>(x) * Span.stepX;
+			float positionY = Span.positionY + static_cast<float>(x) * Span.stepY;
+			float cellX     = static_cast<float>(static_cast<int>(positionX));
+			float cellY     = static_cast<float>(static_cast<int>(positionY));
+			float fractionX = ceiling ? cellX - positionX : positionX - cellX;
+			float fractionY = ceiling ? cellY - positionY : positionY - cellY;
+			int   textureX  = static_cast<int>(width * fractionX) & (Span.textureWidth - 1);
+			int   textureY  = static_cast<int>(height * fractionY) & (Span.textureHeight - 1);
+
+			auto textureColor = Span.texture[Span.textureWidth * textureY + textureX];
+			// 如果启用了烟雾，则计算烟雾效果
+			if constexpr (fog) {
+				textureColor = RGB(Span.colormap[GetRValue(textureColor)], Span.colormap[256 + GetGValue(textureColor)],
+				                   Span.colormap[512 + GetBValue(textureColor)]);
+			}
+
+			// 使颜色略黑
+			Span.output[x] = (textureColor >> 1) & 8355711;
+		}
+	}
+
+	template void RenderFloorSpanScalar<0>(const FloorSpan &Span);
+	template void RenderFloorSpanScalar<FloorFeature::Ceiling>(const FloorSpan &Span);
+	template void RenderFloorSpanScalar<FloorFeature::Fog>(const FloorSpan &Span);
+	template void RenderFloorSpanScalar<FloorFeature::Ceiling | FloorFeature::Fog>(const FloorSpan &Span);
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2023~Now Margoo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * \file RCSpanKernelAVX2.cpp
+ * \brief 地板与天花板的行扫描内核的 AVX2 实现，一次处理 8 个像素
+ *
+ * 该文件需要以对应的指令集编译（见 CMakeLists.txt），并且禁止编译器将乘法与加法合并为 FMA，
+ * 以保证与标量实现的结果逐位一致
+ */
+
+#include <include/RCSpanKernel.h>
+
+#include <immintrin.h>
+
+namespace RCRender {
+	template <unsigned Features>
+	void RenderFloorSpanAVX2(const FloorSpan &Span) {
+		const int count     = Span.end - Span.begin;
+		const int vectorEnd = Span.begin + (count & ~7);
+
+		// 纯烟雾行，直接填充
+		if (Span.saturated) {
+			const __m256i color = _mm256_set1_epi32(static_cast<int>((Span.fogColor >> 1) & 8355711));
+			int x = Span.begin;
+			for (; x < vectorEnd; x += 8) {
+				_mm256_storeu_si256(reinterpret_cast<__m256i *>(Span.output + x), color);
+			}
+			for (; x < Span.end; ++x) {
+				Span.output[x] = (Span.fogColor >> 1) & 8355711;
+			}
+
+			return;
+		}
+
+		const __m256  lane        = _mm256_setr_ps(0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f);
+		const __m256  positionX   = _mm256_set1_ps(Span.positionX);
+		const __m256  positionY   = _mm256_set1_ps(Span.positionY);
+		const __m256  stepX       = _mm256_set1_ps(Span.stepX);
+		const __m256  stepY       = _mm256_set1_ps(Span.stepY);
+		const __m256  width       = _mm256_set1_ps(static_cast<float>(Span.textureWidth));
+		const __m256  height      = _mm256_set1_ps(static_cast<float>(Span.textureHeight));
+		const __m256i widthMask   = _mm256_set1_epi32(Span.textureWidth - 1);
+		const __m256i heightMask  = _mm256_set1_epi32(Span.textureHeight - 1);
+		const __m256i stride      = _mm256_set1_epi32(Span.textureWidth);
+		const __m256i channelMask = _mm256_set1_epi32(0xFF);
+		const __m256i darkenMask  = _mm256_set1_epi32(8355711);
+		const __m256i greenOffset = _mm256_set1_epi32(256);
+		const __m256i blueOffset  = _mm256_set1_epi32(512);
+		const BYTE   *colormap    = Span.colormap;
+
+		int x = Span.begin;
+		for (; x < vectorEnd; x += 8) {
+			const __m256 offset = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(x)), lane);
+			const __m256 realX  = _mm256_add_ps(positionX, _mm256_mul_ps(offset, stepX));
+			const __m256 realY  = _mm256_add_ps(positionY, _mm256_mul_ps(offset, stepY));
+			const __m256 cellX  = _mm256_cvtepi32_ps(_mm256_cvttps_epi32(realX));
+			const __m256 cellY  = _mm256_cvtepi32_ps(_mm256_cvttps_epi32(realY));
+
+			__m256 fractionX;
+			__m256 fractionY;
+			if constexpr ((Features & FloorFeature::Ceiling) != 0) {
+				fractionX = _mm256_sub_ps(cellX, realX);
+				fractionY = _mm256_sub_ps(cellY, realY);
+			} else {
+				fractionX = _mm256_sub_ps(realX, cellX);
+				fractionY = _mm256_sub_ps(realY, cellY);
+			}
+
+			const __m256i textureX = _mm256_and_si256(_mm256_cvttps_epi32(_mm256_mul_ps(width, fractionX)), widthMask);
+			const __m256i textureY = _mm256_and_si256(_mm256_cvttps_epi32(_mm256_mul_ps(height, fractionY)), heightMask);
+			const __m256i index    = _mm256_add_epi32(_mm256_mullo_epi32(textureY, stride), textureX);
+
+			__m256i color = _mm256_i32gather_epi32(reinterpret_cast<const int *>(Span.texture), index, 4);
+			if constexpr ((Features & FloorFeature::Fog) != 0) {
+				// 颜色表按字节存放，以 1 为比例收集 32 位后只保留最低字节
+				const __m256i r = _mm256_and_si256(color, channelMask);
+				const __m256i g = _mm256_add_epi32(_mm256_and_si256(_mm256_srli_epi32(color, 8), channelMask), greenOffset);
+				const __m256i b = _mm256_add_epi32(_mm256_and_si256(_mm256_srli_epi32(color, 16), channelMask), blueOffset);
+
+				const auto    table  = reinterpret_cast<const int *>(colormap);
+				const __m256i blendR = _mm256_and_si256(_mm256_i32gather_epi32(table, r, 1), channelMask);
+				const __m256i blendG = _mm256_and_si256(_mm256_i32gather_epi32(table, g, 1), channelMask);
+				const __m256i blendB = _mm256_and_si256(_mm256_i32gather_epi32(table, b, 1), channelMask);
+
+				color = _mm256_or_si256(blendR, _mm256_or_si256(_mm256_slli_epi32(blendG, 8), _mm256_slli_epi32(blendB, 16)));
+			}
+
+			// 使颜色略黑
+			color = _mm256_and_si256(_mm256_srli_epi32(color, 1), darkenMask);
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(Span.output + x), color);
+		}
+
+		// 剩余的像素交由标量实现
+		if (x < Span.end) {
+			FloorSpan tail = Span;
+			tail.begin     = x;
+			RenderFloorSpanScalar<Features>(tail);
+		}
+	}
+
+	template void RenderFloorSpanAVX2<0>(const FloorSpan &Span);
+	template void RenderFloorSpanAVX2<FloorFeature::Ceiling>(const FloorSpan &Span);
+	template void RenderFloorSpanAVX2<FloorFeature::Fog>(const FloorSpan &Span);
+	template void RenderFloorSpanAVX2<FloorFeature::Ceiling | FloorFeature::Fog>(const FloorSpan &Span);
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2023~Now Margoo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * \file RCSpanKernelSSE41.cpp
+ * \brief 地板与天花板的行扫描内核的 SSE4.1 实现，一次处理 4 个像素
+ *
+ * 该文件需要以对应的指令集编译（见 CMakeLists.txt），并且禁止编译器将乘法与加法合并为 FMA，
+ * 以保证与标量实现的结果逐位一致
+ */
+
+#include <include/RCSpanKernel.h>
+
+#include <smmintrin.h>
+
+namespace RCRender {
+	template <unsigned Features>
+	void RenderFloorSpanSSE41(const FloorSpan &Span) {
+		const int count     = Span.end - Span.begin;
+		const int vectorEnd = Span.begin + (count & ~3);
+
+		// 纯烟雾行，直接填充
+		if (Span.saturated) {
+			const __m128i color = _mm_set1_epi32(static_cast<int>((Span.fogColor >> 1) & 8355711));
+			int x = Span.begin;
+			for (; x < vectorEnd; x += 4) {
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(Span.output + x), color);
+			}
+			for (; x < Span.end; ++x) {
+				Span.output[x] = (Span.fogColor >> 1) & 8355711;
+			}
+
+			return;
+		}
+
+		const __m128  lane        = _mm_setr_ps(0.f, 1.f, 2.f, 3.f);
+		const __m128  positionX   = _mm_set1_ps(Span.positionX);
+		const __m128  positionY   = _mm_set1_ps(Span.positionY);
+		const __m128  stepX       = _mm_set1_ps(Span.stepX);
+		const __m128  stepY       = _mm_set1_ps(Span.stepY);
+		const __m128  width       = _mm_set1_ps(static_cast<float>(Span.textureWidth));
+		const __m128  height      = _mm_set1_ps(static_cast<float>(Span.textureHeight));
+		const __m128i widthMask   = _mm_set1_epi32(Span.textureWidth - 1);
+		const __m128i heightMask  = _mm_set1_epi32(Span.textureHeight - 1);
+		const __m128i stride      = _mm_set1_epi32(Span.textureWidth);
+		const __m128i darkenMask  = _mm_set1_epi32(8355711);
+		const BYTE   *colormap    = Span.colormap;
+
+		int x = Span.begin;
+		for (; x < vectorEnd; x += 4) {
+			const __m128 offset = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), lane);
+			const __m128 realX  = _mm_add_ps(positionX, _mm_mul_ps(offset, stepX));
+			const __m128 realY  = _mm_add_ps(positionY, _mm_mul_ps(offset, stepY));
+			const __m128 cellX  = _mm_cvtepi32_ps(_mm_cvttps_epi32(realX));
+			const __m128 cellY  = _mm_cvtepi32_ps(_mm_cvttps_epi32(realY));
+
+			__m128 fractionX;
+			__m128 fractionY;
+			if constexpr ((Features & FloorFeature::Ceiling) != 0) {
+				fractionX = _mm_sub_ps(cellX, realX);
+				fractionY = _mm_sub_ps(cellY, realY);
+			} else {
+				fractionX = _mm_sub_ps(realX, cellX);
+				fractionY = _mm_sub_ps(realY, cellY);
+			}
+
+			const __m128i textureX = _mm_and_si128(_mm_cvttps_epi32(_mm_mul_ps(width, fractionX)), widthMask);
+			const __m128i textureY = _mm_and_si128(_mm_cvttps_epi32(_mm_mul_ps(height, fractionY)), heightMask);
+			const __m128i index    = _mm_add_epi32(_mm_mullo_epi32(textureY, stride), textureX);
+
+			// SSE4.1 没有收集指令，逐个读取纹理，烟雾颜色表也在此逐个查找
+			alignas(16) DWORD texel[4] = { Span.texture[_mm_extract_epi32(index, 0)], Span.texture[_mm_extract_epi32(index, 1)],
+			                               Span.texture[_mm_extract_epi32(index, 2)], Span.texture[_mm_extract_epi32(index, 3)] };
+			if constexpr ((Features & FloorFeature::Fog) != 0) {
+				for (auto &value : texel) {
+					value = RGB(colormap[GetRValue(value)], colormap[256 + GetGValue(value)], colormap[512 + GetBValue(value)]);
+				}
+			}
+			__m128i color = _mm_load_si128(reinterpret_cast<const __m128i *>(texel));
+
+			// 使颜色略黑
+			color = _mm_and_si128(_mm_srli_epi32(color, 1), darkenMask);
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(Span.output + x), color);
+		}
+
+		// 剩余的像素交由标量实现
+		if (x < Span.end) {
+			FloorSpan tail = Span;
+			tail.begin     = x;
+			RenderFloorSpanScalar<Features>(tail);
+		}
+	}
+
+	template void RenderFloorSpanSSE41<0>(const FloorSpan &Span);
+	template void RenderFloorSpanSSE41<FloorFeature::Ceiling>(const FloorSpan &Span);
+	template void RenderFloorSpanSSE41<FloorFeature::Fog>(const FloorSpan &Span);
+	template void RenderFloorSpanSSE41<FloorFeature::Ceiling | FloorFeature::Fog>(const FloorSpan &Span);
+}
@@ -27,6 +27,9 @@
 
 #include <include/RCTexture.h>
 
+#include <algorithm>
+#include <cmath>
+
 RCTexture::RCTexture(RCContext* Context) {
 	if (Context == nullptr) {
 		_context = nullptr;
@@ -35,6 +38,125 @@ RCTexture::RCTexture(RCContext* Context) {
 	}
 	else {
 		_context = Context;
-		_buffer  = GetImageBuffer(_context->_context);
+		_buffer  = _context->GetBuffer();
+
+		// 预先检查纹理是否完全不透明，供渲染器判断墙体是否会完全遮挡背景
+		_opaque = true;
+		const int size = _context->GetWidth() * _context->GetHeight();
+		for (int position = 0; position < size; ++position) {
+			if ((_buffer[position] & 0xFF000000) == 0) {
+				_opaque = false;
+
+				break;
+			}
+		}
+
+		BuildMipChain();
+	}
+}
+bool RCTexture::IsOpaque() const {
+	return _opaque;
+}
+int RCTexture::GetMipLevelCount() const {
+	return static_cast<int>(_mipLevels.size());
+}
+int RCTexture::SelectMipLevel(const float &TexelsPerPixel) const {
+	if (!(TexelsPerPixel >= 2)) {
+		return 0;
+	}
+
+	// 每个像素跨越 2^n 到 2^(n + 1) 个纹素时使用第 n 层
+	const int level = std::ilogb(TexelsPerPixel);
+
+	return level < static_cast<int>(_mipLevels.size()) ? level : static_cast<int>(_mipLevels.size()) - 1;
+}
+void RCTexture::BuildMipChain() {
+	int width  = _context->GetWidth();
+	int height = _context->GetHeight();
+
+	// 预先计算全部层级的大小，保证 _mipStorage 不会在生成过程中重新分配
+	size_t storageSize = 0;
+	for (int levelWidth = width, levelHeight = height; levelWidth > 1 || levelHeight > 1;) {
+		levelWidth  = (levelWidth + 1) / 2;
+		levelHeight = (levelHeight + 1) / 2;
+		storageSize += static_cast<size_t>(levelWidth) * levelHeight;
+	}
+	_mipStorage.resize(storageSize);
+	_mipLevels.push_back({ _buffer, nullptr, width, height });
+
+	DWORD *target = _mipStorage.data();
+	while (width > 1 || height > 1) {
+		const DWORD *source       = _mipLevels.back().buffer;
+		const int    sourceWidth  = width;
+		const int    sourceHeight = height;
+		width  = (width + 1) / 2;
+		height = (height + 1) / 2;
+
+		for (int y = 0; y < height; ++y) {
+			for (int x = 0; x < width; ++x) {
+				// 对 2x2 的纹素取平均，奇数边长的最后一列（行）与自身取平均
+				const int   left   = 2 * x;
+				const int   right  = std::min(2 * x + 1, sourceWidth - 1);
+				const int   top    = 2 * y;
+				const int   bottom = std::min(2 * y + 1, sourceHeight - 1);
+				const DWORD texels[4] = { source[top * sourceWidth + left], source[top * sourceWidth + right],
+				                          source[bottom * sourceWidth + left], source[bottom * sourceWidth + right] };
+
+				// 只混合不透明的纹素，以免透明像素的颜色渗入镂空纹理的边缘，
+				// 至少一半的纹素不透明时该纹素才不透明
+				int r = 0, g = 0, b = 0, opaqueCount = 0;
+				for (const auto &texel : texels) {
+					if ((texel & 0xFF000000) != 0) {
+						r += GetRValue(texel);
+						g += GetGValue(texel);
+						b += GetBValue(texel);
+						++opaqueCount;
+					}
+				}
+
+				DWORD color = 0;
+				if (opaqueCount >= 2) {
+					color = 0xFF000000 | RGB((r + opaqueCount / 2) / opaqueCount, (g + opaqueCount / 2) / opaqueCount,
+					                         (b + opaqueCount / 2) / opaqueCount);
+				}
+				target[y * width + x] = color;
+			}
+		}
+
+		_mipLevels.push_back({ target, nullptr, width, height });
+		target += static_cast<size_t>(width) * height;
+	}
+}
+void RCTexture::EnableColumnMajor(const bool &Status) {
+	if (!Status) {
+		for (auto &level : _mipLevels) {
+			level.columnBuffer = nullptr;
+		}
+		std::vector<DWORD>().swap(_columnMajorStorage);
+
+		return;
+	}
+	if (!_columnMajorStorage.empty()) {
+		return;
+	}
+
+	size_t storageSize = 0;
+	for (const auto &level : _mipLevels) {
+		storageSize += static_cast<size_t>(level.width) * level.height;
+	}
+	_columnMajorStorage.resize(storageSize);
+
+	DWORD *target = _columnMajorStorage.data();
+	for (auto &level : _mipLevels) {
+		for (int x = 0; x < level.width; ++x) {
+			for (int y = 0; y < level.height; ++y) {
+				target[x * level.height + y] = level.buffer[y * level.width + x];
+			}
+		}
+		level.columnBuffer = target;
+		target += static_cast<size_t>(level.width) * level.height;
 	}
+}
+size_t RCTexture::GetColumnMajorSize() const {
+	return _columnMajorStorage.size() * sizeof(DWORD);
 }
\ No newline at end of file
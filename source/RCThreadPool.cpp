@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2023~Now Margoo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * \file RCThreadPool.cpp
+ * \brief 渲染器使用的常驻线程池
+ */
+
+#include <include/RCThreadPool.h>
+#include <include/RCTrace.h>
+
+#include <string>
+
+RCThreadPool::RCThreadPool(const int &ThreadCount)
+    : _task(nullptr), _generation(0), _pending(0), _exit(false) {
+	if (ThreadCount <= 0) {
+		throw RCInvalidParameterException("non-positive thread count", "RCThreadPool construction");
+	}
+
+	// 下标 0 的任务由调用线程执行
+	for (int count = 1; count < ThreadCount; ++count) {
+		_workers.emplace_back(&RCThreadPool::WorkerProcess, this, count);
+	}
+}
+RCThreadPool::~RCThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_exit = true;
+	}
+	_taskCondition.notify_all();
+	for (auto &worker : _workers) {
+		worker.join();
+	}
+}
+int RCThreadPool::GetThreadCount() const {
+	return static_cast<int>(_workers.size()) + 1;
+}
+void RCThreadPool::Dispatch(const std::function<void(const int &)> &Task) {
+	if (_workers.empty()) {
+		Task(0);
+
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_task    = &Task;
+		_pending = static_cast<int>(_workers.size());
+		++_generation;
+	}
+	_taskCondition.notify_all();
+
+	// 工作线程仍持有 Task 的指针，调用线程的任务抛出异常时也必须等待它们完成
+	std::exception_ptr exception;
+	try {
+		Task(0);
+	} catch (...) {
+		exception = std::current_exception();
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		_doneCondition.wait(lock, [this]() -> bool {
+			return _pending == 0;
+		});
+		_task = nullptr;
+		if (!exception) {
+			exception = _exception;
+		}
+		_exception = nullptr;
+	}
+
+	if (exception) {
+		std::rethrow_exception(exception);
+	}
+}
+void RCThreadPool::WorkerProcess(const int &Index) {
+	RCTracer::SetThreadName(("RCThreadPool worker " + std::to_string(Index)).c_str());
+
+	unsigned long long generation = 0;
+	while (true) {
+		const std::function<void(const int &)> *task;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_taskCondition.wait(lock, [this, &generation]() -> bool {
+				return _exit || _generation != generation;
+			});
+			if (_exit) {
+				return;
+			}
+			generation = _generation;
+			task       = _task;
+		}
+
+		std::exception_ptr exception;
+		try {
+			(*task)(Index);
+		} catch (...) {
+			exception = std::current_exception();
+		}
+
+		bool done;
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			if (exception && !_exception) {
+				_exception = exception;
+			}
+			done = --_pending == 0;
+		}
+		if (done) {
+			_doneCondition.notify_one();
+		}
+	}
+}
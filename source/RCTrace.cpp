@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2023~Now Margoo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/**
+ * \file RCTrace.cpp
+ * \brief 以 Chrome trace event 格式记录渲染与交互时间线的跟踪器
+ */
+
+#include <include/RCTrace.h>
+#include <include/RCException.h>
+
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+	/**
+	 * 一个区间，时刻以相对于跟踪器创建时刻的纳秒数表示
+	 */
+	struct TraceEvent {
+		const char *name;
+		const char *category;
+		long long   start;
+		long long   duration;
+	};
+	/**
+	 * 线程独占的缓冲区，只有所属线程写入；count 以 release 语义发布，导出时以 acquire 语义读取。
+	 * 区间数组在第一次记录时才分配，只设置了名称的线程不占用区间数组的内存
+	 */
+	struct ThreadBuffer {
+		std::unique_ptr<TraceEvent[]> events;
+		std::atomic<size_t>           count{ 0 };
+		std::atomic<size_t>           dropped{ 0 };
+		int                           threadId = 0;
+		std::string                   name;
+	};
+	/**
+	 * 所有线程的缓冲区，缓冲区在线程退出后仍然保留，以便导出其记录的区间
+	 */
+	struct TraceRegistry {
+		std::mutex                                 mutex;
+		std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+		std::chrono::steady_clock::time_point      epoch = std::chrono::steady_clock::now();
+	};
+
+	TraceRegistry &GetRegistry() {
+		static TraceRegistry registry;
+
+		return registry;
+	}
+	ThreadBuffer &GetThreadBuffer() {
+		thread_local ThreadBuffer *threadBuffer = nullptr;
+		if (threadBuffer == nullptr) {
+			auto &registry = GetRegistry();
+			auto  buffer   = std::make_unique<ThreadBuffer>();
+
+			std::lock_guard<std::mutex> lock(registry.mutex);
+			buffer->threadId = static_cast<int>(registry.buffers.size()) + 1;
+			buffer->name     = "Thread " + std::to_string(buffer->threadId);
+			threadBuffer     = buffer.get();
+			registry.buffers.push_back(std::move(buffer));
+		}
+
+		return *threadBuffer;
+	}
+	void WriteJSONString(std::ostream &Stream, const char *String) {
+		Stream << '"';
+		for (auto character = String; *character != '\0'; ++character) {
+			if (*character == '"' || *character == '\\') {
+				Stream << '\\' << *character;
+			} else if (static_cast<unsigned char>(*character) < 0x20) {
+				Stream << ' ';
+			} else {
+				Stream << *character;
+			}
+		}
+		Stream << '"';
+	}
+}
+
+void RCTracer::Enable(const bool &Status) {
+	// 确保跟踪器的起始时刻早于启用后记录的任何区间
+	GetRegistry();
+	_enabled.store(Status, std::memory_order_relaxed);
+}
+void RCTracer::SetThreadName(const char *Name) {
+	auto &buffer   = GetThreadBuffer();
+	auto &registry = GetRegistry();
+
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	buffer.name = Name;
+}
+void RCTracer::Record(const char *Name, const char *Category, const std::chrono::steady_clock::time_point &Start,
+                      const std::chrono::steady_clock::time_point &End) {
+	auto        &buffer = GetThreadBuffer();
+	const size_t count  = buffer.count.load(std::memory_order_relaxed);
+	if (count >= BufferCapacity) {
+		buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+
+		return;
+	}
+	if (buffer.events == nullptr) {
+		buffer.events = std::make_unique<TraceEvent[]>(BufferCapacity);
+	}
+
+	const auto epoch     = GetRegistry().epoch;
+	buffer.events[count] = { Name, Category,
+	                         std::chrono::duration_cast<std::chrono::nanoseconds>(Start - epoch).count(),
+	                         std::chrono::duration_cast<std::chrono::nanoseconds>(End - Start).count() };
+	buffer.count.store(count + 1, std::memory_order_release);
+}
+void RCTracer::Clear() {
+	auto &registry = GetRegistry();
+
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	for (auto &buffer : registry.buffers) {
+		buffer->count.store(0, std::memory_order_relaxed);
+		buffer->dropped.store(0, std::memory_order_relaxed);
+	}
+}
+size_t RCTracer::GetDroppedCount() {
+	auto &registry = GetRegistry();
+
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	size_t dropped = 0;
+	for (auto &buffer : registry.buffers) {
+		dropped += buffer->dropped.load(std::memory_order_relaxed);
+	}
+
+	return dropped;
+}
+void RCTracer::WriteJSON(std::ostream &Stream) {
+	auto &registry = GetRegistry();
+
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	const auto flags     = Stream.flags();
+	const auto precision = Stream.precision();
+	Stream << std::fixed << std::setprecision(3);
+
+	// 时刻与时长以微秒为单位，"X" 为带时长的完整区间，"M" 为线程名称等元数据
+	Stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	bool first = true;
+	for (auto &buffer : registry.buffers) {
+		Stream << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadId
+		       << ",\"args\":{\"name\":";
+		WriteJSONString(Stream, buffer->name.c_str());
+		Stream << "}}";
+		first = false;
+
+		const size_t count = buffer->count.load(std::memory_order_acquire);
+		for (size_t index = 0; index < count; ++index) {
+			const auto &event = buffer->events[index];
+			Stream << ",\n{\"name\":";
+			WriteJSONString(Stream, event.name);
+			Stream << ",\"cat\":";
+			WriteJSONString(Stream, event.category);
+			Stream << ",\"ph\":\"X\",\"ts\":" << static_cast<double>(event.start) / 1000.0
+			       << ",\"dur\":" << static_cast<double>(event.duration) / 1000.0 << ",\"pid\":1,\"tid\":"
+			       << buffer->threadId << "}";
+		}
+	}
+	Stream << "\n]}\n";
+
+	Stream.flags(flags);
+	Stream.precision(precision);
+}
+void RCTracer::DumpJSON(const char *Path) {
+	std::ofstream stream(Path);
+	if (!stream) {
+		throw RCCreationFailure("trace JSON file");
+	}
+
+	WriteJSON(stream);
+}
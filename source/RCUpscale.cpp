@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2023~Now Margoo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/**
+ * \file RCUpscale.cpp
+ * \brief 画面放大内核的标量实现，以及运行时分发
+ */
+
+#include <include/RCUpscale.h>
+
+#include <algorithm>
+
+namespace RCRender {
+	UpscaleKernel GetUpscaleKernel(const UpscaleFilter &Filter, const InstructionSet &Set) {
+		if (Filter == UpscaleFilter::Nearest) {
+			// 最近邻插值只有读写，SSE4.1 没有 gather 指令，无法比标量实现更快
+			return Set == InstructionSet::AVX2 ? UpscaleNearestAVX2 : UpscaleNearestScalar;
+		}
+
+		switch (Set) {
+			case InstructionSet::AVX2: {
+				return UpscaleBilinearAVX2;
+			}
+			case InstructionSet::SSE41: {
+				return UpscaleBilinearSSE41;
+			}
+			default: {
+				return UpscaleBilinearScalar;
+			}
+		}
+	}
+	void UpscaleNearestScalar(const DWORD *Source, const int &SourceStride, const int &SourceWidth,
+	                          const int &SourceHeight, DWORD *Target, const int &TargetStride, const int &TargetWidth,
+	                          const int &TargetHeight, const int &RowStart, const int &RowEnd) {
+		// 使用 16.16 定点数进行步进，避免逐像素的除法
+		const int stepX = (SourceWidth << 16) / TargetWidth;
+		const int stepY = (SourceHeight << 16) / TargetHeight;
+
+		for (int y = RowStart; y < RowEnd; ++y) {
+			auto targetLine = Target + y * TargetStride;
+			if (y > RowStart && (y * stepY) >> 16 == ((y - 1) * stepY) >> 16) {
+				std::copy(targetLine - TargetStride, targetLine - TargetStride + TargetWidth, targetLine);
+				continue;
+			}
+
+			auto sourceLine = Source + ((y * stepY) >> 16) * SourceStride;
+			for (int x = 0, sourceX = 0; x < TargetWidth; ++x, sourceX += stepX) {
+				targetLine[x] = sourceLine[sourceX >> 16];
+			}
+		}
+	}
+	void UpscaleBilinearScalar(const DWORD *Source, const int &SourceStride, const int &SourceWidth,
+	                           const int &SourceHeight, DWORD *Target, const int &TargetStride, const int &TargetWidth,
+	                           const int &TargetHeight, const int &RowStart, const int &RowEnd) {
+		const auto axisX = MakeBilinearAxis(SourceWidth, TargetWidth);
+		const auto axisY = MakeBilinearAxis(SourceHeight, TargetHeight);
+
+		for (int y = RowStart; y < RowEnd; ++y) {
+			const int  sourceY    = std::clamp(axisY.start + y * axisY.step, 0, axisY.limit);
+			const int  weightY    = (sourceY >> 8) & 0xFF;
+			const auto topLine    = Source + (sourceY >> 16) * SourceStride;
+			const auto bottomLine = Source + std::min((sourceY >> 16) + 1, SourceHeight - 1) * SourceStride;
+			auto       targetLine = Target + y * TargetStride;
+
+			for (int x = 0; x < TargetWidth; ++x) {
+				const int sourceX = std::clamp(axisX.start + x * axisX.step, 0, axisX.limit);
+				const int left    = sourceX >> 16;
+				const int right   = std::min(left + 1, SourceWidth - 1);
+				const int weightX = (sourceX >> 8) & 0xFF;
+
+				// 先在上下两行中水平插值，再在两个结果之间垂直插值
+				targetLine[x] = LerpPixel(LerpPixel(topLine[left], topLine[right], weightX),
+				                          LerpPixel(bottomLine[left], bottomLine[right], weightX), weightY);
+			}
+		}
+	}
+}
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2023~Now Margoo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/**
+ * \file RCUpscaleAVX2.cpp
+ * \brief 画面放大内核的 AVX2 实现，以 gather 指令一次读取 8 个像素
+ *
+ * 该文件需要以对应的指令集编译（见 CMakeLists.txt）
+ */
+
+#include <include/RCUpscale.h>
+
+#include <algorithm>
+#include <immintrin.h>
+
+namespace RCRender {
+	namespace {
+		/**
+		 * 以 16 位通道计算 (A * Inverse + B * Weight) >> 8，单个通道的结果不超过 16 位
+		 */
+		inline __m256i Lerp(const __m256i &A, const __m256i &B, const __m256i &Weight, const __m256i &Inverse) {
+			return _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(A, Inverse), _mm256_mullo_epi16(B, Weight)), 8);
+		}
+	}
+
+	void UpscaleNearestAVX2(const DWORD *Source, const int &SourceStride, const int &SourceWidth,
+	                        const int &SourceHeight, DWORD *Target, const int &TargetStride, const int &TargetWidth,
+	                        const int &TargetHeight, const int &RowStart, const int &RowEnd) {
+		const int stepX = (SourceWidth << 16) / TargetWidth;
+		const int stepY = (SourceHeight << 16) / TargetHeight;
+
+		const __m256i laneOffset  = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(stepX));
+		const int     vectorWidth = TargetWidth & ~7;
+
+		for (int y = RowStart; y < RowEnd; ++y) {
+			auto targetLine = Target + y * TargetStride;
+			if (y > RowStart && (y * stepY) >> 16 == ((y - 1) * stepY) >> 16) {
+				std::copy(targetLine - TargetStride, targetLine - TargetStride + TargetWidth, targetLine);
+				continue;
+			}
+
+			auto sourceLine = reinterpret_cast<const int *>(Source + ((y * stepY) >> 16) * SourceStride);
+			int  x          = 0;
+			for (; x < vectorWidth; x += 8) {
+				const __m256i sourceX = _mm256_add_epi32(_mm256_set1_epi32(x * stepX), laneOffset);
+				const __m256i pixel   = _mm256_i32gather_epi32(sourceLine, _mm256_srli_epi32(sourceX, 16), 4);
+				_mm256_storeu_si256(reinterpret_cast<__m256i *>(targetLine + x), pixel);
+			}
+			for (; x < TargetWidth; ++x) {
+				targetLine[x] = static_cast<DWORD>(sourceLine[(x * stepX) >> 16]);
+			}
+		}
+	}
+	void UpscaleBilinearAVX2(const DWORD *Source, const int &SourceStride, const int &SourceWidth,
+	                         const int &SourceHeight, DWORD *Target, const int &TargetStride, const int &TargetWidth,
+	                         const int &TargetHeight, const int &RowStart, const int &RowEnd) {
+		const auto axisX = MakeBilinearAxis(SourceWidth, TargetWidth);
+		const auto axisY = MakeBilinearAxis(SourceHeight, TargetHeight);
+
+		const __m256i zero        = _mm256_setzero_si256();
+		const __m256i full        = _mm256_set1_epi16(256);
+		const __m256i byteMask    = _mm256_set1_epi32(0xFF);
+		const __m256i limitX      = _mm256_set1_epi32(axisX.limit);
+		const __m256i lastX       = _mm256_set1_epi32(SourceWidth - 1);
+		const __m256i laneOffset  = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(axisX.step));
+		const int     vectorWidth = TargetWidth & ~7;
+
+		for (int y = RowStart; y < RowEnd; ++y) {
+			const int  sourceY    = std::clamp(axisY.start + y * axisY.step, 0, axisY.limit);
+			const int  weightY    = (sourceY >> 8) & 0xFF;
+			const auto topLine    = Source + (sourceY >> 16) * SourceStride;
+			const auto bottomLine = Source + std::min((sourceY >> 16) + 1, SourceHeight - 1) * SourceStride;
+			auto       targetLine = Target + y * TargetStride;
+
+			const auto    top             = reinterpret_cast<const int *>(topLine);
+			const auto    bottom          = reinterpret_cast<const int *>(bottomLine);
+			const __m256i verticalWeight  = _mm256_set1_epi16(static_cast<short>(weightY));
+			const __m256i verticalInverse = _mm256_sub_epi16(full, verticalWeight);
+
+			int x = 0;
+			for (; x < vectorWidth; x += 8) {
+				__m256i sourceX = _mm256_add_epi32(_mm256_set1_epi32(axisX.start + x * axisX.step), laneOffset);
+				sourceX         = _mm256_min_epi32(_mm256_max_epi32(sourceX, zero), limitX);
+
+				const __m256i left   = _mm256_srli_epi32(sourceX, 16);
+				const __m256i right  = _mm256_min_epi32(_mm256_add_epi32(left, _mm256_set1_epi32(1)), lastX);
+				const __m256i weight = _mm256_and_si256(_mm256_srli_epi32(sourceX, 8), byteMask);
+
+				const __m256i topLeft     = _mm256_i32gather_epi32(top, left, 4);
+				const __m256i topRight    = _mm256_i32gather_epi32(top, right, 4);
+				const __m256i bottomLeft  = _mm256_i32gather_epi32(bottom, left, 4);
+				const __m256i bottomRight = _mm256_i32gather_epi32(bottom, right, 4);
+
+				// 将权重复制到像素的 4 个通道上，排列方式与 unpacklo / unpackhi 展开的像素一致：
+				// 低半部分为每个 128 位通道中的前两个像素，高半部分为后两个像素
+				const __m256i channelWeight = _mm256_or_si256(weight, _mm256_slli_epi32(weight, 16));
+				const __m256i weightLow     = _mm256_unpacklo_epi32(channelWeight, channelWeight);
+				const __m256i weightHigh    = _mm256_unpackhi_epi32(channelWeight, channelWeight);
+				const __m256i inverseLow    = _mm256_sub_epi16(full, weightLow);
+				const __m256i inverseHigh   = _mm256_sub_epi16(full, weightHigh);
+
+				// 先在上下两行中水平插值，再在两个结果之间垂直插值，与标量实现的顺序一致
+				const __m256i low  = Lerp(Lerp(_mm256_unpacklo_epi8(topLeft, zero), _mm256_unpacklo_epi8(topRight, zero), weightLow, inverseLow),
+				                          Lerp(_mm256_unpacklo_epi8(bottomLeft, zero), _mm256_unpacklo_epi8(bottomRight, zero), weightLow, inverseLow),
+				                          verticalWeight, verticalInverse);
+				const __m256i high = Lerp(Lerp(_mm256_unpackhi_epi8(topLeft, zero), _mm256_unpackhi_epi8(topRight, zero), weightHigh, inverseHigh),
+				                          Lerp(_mm256_unpackhi_epi8(bottomLeft, zero), _mm256_unpackhi_epi8(bottomRight, zero), weightHigh, inverseHigh),
+				                          verticalWeight, verticalInverse);
+
+				_mm256_storeu_si256(reinterpret_cast<__m256i *>(targetLine + x), _mm256_packus_epi16(low, high));
+			}
+			for (; x < TargetWidth; ++x) {
+				const int sourceX = std::clamp(axisX.start + x * axisX.step, 0, axisX.limit);
+				const int left    = sourceX >> 16;
+				const int right   = std::min(left + 1, SourceWidth - 1);
+				const int weightX = (sourceX >> 8) & 0xFF;
+
+				targetLine[x] = LerpPixel(LerpPixel(topLine[left], topLine[right], weightX),
+				                          LerpPixel(bottomLine[left], bottomLine[right], weightX), weightY);
+			}
+		}
+	}
+}
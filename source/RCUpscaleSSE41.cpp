@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2023~Now Margoo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/**
+ * \file RCUpscaleSSE41.cpp
+ * \brief 画面放大内核的 SSE4.1 实现
+ *
+ * 该文件需要以对应的指令集编译（见 CMakeLists.txt）
+ */
+
+#include <include/RCUpscale.h>
+
+#include <algorithm>
+#include <smmintrin.h>
+
+namespace RCRender {
+	namespace {
+		/**
+		 * 以 16 位通道计算 (A * Inverse + B * Weight) >> 8，单个通道的结果不超过 16 位
+		 */
+		inline __m128i Lerp(const __m128i &A, const __m128i &B, const __m128i &Weight, const __m128i &Inverse) {
+			return _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(A, Inverse), _mm_mullo_epi16(B, Weight)), 8);
+		}
+	}
+
+	void UpscaleBilinearSSE41(const DWORD *Source, const int &SourceStride, const int &SourceWidth,
+	                          const int &SourceHeight, DWORD *Target, const int &TargetStride, const int &TargetWidth,
+	                          const int &TargetHeight, const int &RowStart, const int &RowEnd) {
+		const auto axisX = MakeBilinearAxis(SourceWidth, TargetWidth);
+		const auto axisY = MakeBilinearAxis(SourceHeight, TargetHeight);
+
+		const __m128i zero        = _mm_setzero_si128();
+		const __m128i full        = _mm_set1_epi16(256);
+		const int     vectorWidth = TargetWidth & ~3;
+
+		for (int y = RowStart; y < RowEnd; ++y) {
+			const int  sourceY    = std::clamp(axisY.start + y * axisY.step, 0, axisY.limit);
+			const int  weightY    = (sourceY >> 8) & 0xFF;
+			const auto topLine    = Source + (sourceY >> 16) * SourceStride;
+			const auto bottomLine = Source + std::min((sourceY >> 16) + 1, SourceHeight - 1) * SourceStride;
+			auto       targetLine = Target + y * TargetStride;
+
+			const __m128i verticalWeight  = _mm_set1_epi16(static_cast<short>(weightY));
+			const __m128i verticalInverse = _mm_sub_epi16(full, verticalWeight);
+
+			int x = 0;
+			for (; x < vectorWidth; x += 4) {
+				int left[4];
+				int right[4];
+				int weight[4];
+				for (int lane = 0; lane < 4; ++lane) {
+					const int sourceX = std::clamp(axisX.start + (x + lane) * axisX.step, 0, axisX.limit);
+					left[lane]   = sourceX >> 16;
+					right[lane]  = std::min(left[lane] + 1, SourceWidth - 1);
+					weight[lane] = (sourceX >> 8) & 0xFF;
+				}
+
+				const __m128i topLeft     = _mm_setr_epi32(topLine[left[0]], topLine[left[1]], topLine[left[2]], topLine[left[3]]);
+				const __m128i topRight    = _mm_setr_epi32(topLine[right[0]], topLine[right[1]], topLine[right[2]], topLine[right[3]]);
+				const __m128i bottomLeft  = _mm_setr_epi32(bottomLine[left[0]], bottomLine[left[1]], bottomLine[left[2]], bottomLine[left[3]]);
+				const __m128i bottomRight = _mm_setr_epi32(bottomLine[right[0]], bottomLine[right[1]], bottomLine[right[2]], bottomLine[right[3]]);
+
+				// 每个像素的 4 个通道使用相同的水平权重，低半部分为前两个像素，高半部分为后两个像素
+				const __m128i weightLow   = _mm_setr_epi16(weight[0], weight[0], weight[0], weight[0],
+				                                           weight[1], weight[1], weight[1], weight[1]);
+				const __m128i weightHigh  = _mm_setr_epi16(weight[2], weight[2], weight[2], weight[2],
+				                                           weight[3], weight[3], weight[3], weight[3]);
+				const __m128i inverseLow  = _mm_sub_epi16(full, weightLow);
+				const __m128i inverseHigh = _mm_sub_epi16(full, weightHigh);
+
+				// 先在上下两行中水平插值，再在两个结果之间垂直插值，与标量实现的顺序一致
+				const __m128i low  = Lerp(Lerp(_mm_cvtepu8_epi16(topLeft), _mm_cvtepu8_epi16(topRight), weightLow, inverseLow),
+				                          Lerp(_mm_cvtepu8_epi16(bottomLeft), _mm_cvtepu8_epi16(bottomRight), weightLow, inverseLow),
+				                          verticalWeight, verticalInverse);
+				const __m128i high = Lerp(Lerp(_mm_unpackhi_epi8(topLeft, zero), _mm_unpackhi_epi8(topRight, zero), weightHigh, inverseHigh),
+				                          Lerp(_mm_unpackhi_epi8(bottomLeft, zero), _mm_unpackhi_epi8(bottomRight, zero), weightHigh, inverseHigh),
+				                          verticalWeight, verticalInverse);
+
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(targetLine + x), _mm_packus_epi16(low, high));
+			}
+			for (; x < TargetWidth; ++x) {
+				const int sourceX = std::clamp(axisX.start + x * axisX.step, 0, axisX.limit);
+				const int left    = sourceX >> 16;
+				const int right   = std::min(left + 1, SourceWidth - 1);
+				const int weightX = (sourceX >> 8) & 0xFF;
+
+				targetLine[x] = LerpPixel(LerpPixel(topLine[left], topLine[right], weightX),
+				                          LerpPixel(bottomLine[left], bottomLine[right], weightX), weightY);
+			}
+		}
+	}
+}